@@ -0,0 +1,120 @@
+#include <GameEngine\AssetPack.h>
+
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#endif
+
+/// Adds the file, or every file below the directory
+static void addFiles(const std::string& path, std::vector<std::string>& files){
+#ifdef _WIN32
+	DWORD attributes = GetFileAttributesA(path.c_str());
+	if (attributes == INVALID_FILE_ATTRIBUTES || !(attributes & FILE_ATTRIBUTE_DIRECTORY))
+	{
+		//A missing file is reported by AssetPack::build
+		files.push_back(path);
+		return;
+	}
+
+	WIN32_FIND_DATAA data;
+	HANDLE find = FindFirstFileA((path + "/*").c_str(), &data);
+	if (find == INVALID_HANDLE_VALUE)
+	{
+		return;
+	}
+	do
+	{
+		std::string name = data.cFileName;
+		if (name != "." && name != "..")
+		{
+			addFiles(path + "/" + name, files);
+		}
+	} while (FindNextFileA(find, &data));
+	FindClose(find);
+#else
+	struct stat info;
+	if (stat(path.c_str(), &info) != 0 || !S_ISDIR(info.st_mode))
+	{
+		//A missing file is reported by AssetPack::build
+		files.push_back(path);
+		return;
+	}
+
+	DIR* directory = opendir(path.c_str());
+	if (directory == nullptr)
+	{
+		return;
+	}
+	while (dirent* entry = readdir(directory))
+	{
+		std::string name = entry->d_name;
+		if (name != "." && name != "..")
+		{
+			addFiles(path + "/" + name, files);
+		}
+	}
+	closedir(directory);
+#endif
+}
+
+/// Packs asset files for IOManager::mountPack. Run it in the directory the game runs in, so the paths
+/// in the pack are the ones the game asks for:
+/// AssetPacker -c Assets.pak Textures Shaders Sound Music Fonts Levels
+int main(int argc, char** argv) {
+	int arg = 1;
+	bool compress = false;
+	if (arg < argc && std::string(argv[arg]) == "-c")
+	{
+		compress = true;
+		arg++;
+	}
+
+	if (argc - arg < 2)
+	{
+		printf("Usage: AssetPacker [-c] <pack> <file or directory>...\n");
+		printf("  -c  LZ4 compress the files that get at least an eighth smaller\n");
+		return 1;
+	}
+
+	std::string packPath = argv[arg++];
+	std::vector<std::string> files;
+	for (; arg < argc; arg++)
+	{
+		addFiles(argv[arg], files);
+	}
+
+	//An old pack inside one of the directories doesn't go into the new one
+	std::string normalizedPackPath = GameEngine::AssetPack::normalizePath(packPath);
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		if (GameEngine::AssetPack::normalizePath(files[i]) == normalizedPackPath)
+		{
+			files.erase(files.begin() + i);
+			i--;
+		}
+	}
+
+	std::string errorMessage;
+	if (!GameEngine::AssetPack::build(packPath, files, compress, errorMessage))
+	{
+		fprintf(stderr, "%s\n", errorMessage.c_str());
+		return 1;
+	}
+
+	//Read it back the way the game will
+	GameEngine::AssetPack pack;
+	if (!pack.open(packPath))
+	{
+		fprintf(stderr, "Failed to open '%s' after writing it\n", packPath.c_str());
+		return 1;
+	}
+	printf("Packed %d files into %s\n", (int)pack.size(), packPath.c_str());
+
+	return 0;
+}
@@ -3,9 +3,7 @@
 #include <glm/glm.hpp>
 #include <GameEngine/Vertex.h>
 
-struct Cell;
-
-// POD
+// POD, one ball handed to and out of the BallStore
 struct Ball {
     Ball(float radius, float mass, const glm::vec2& pos,
          const glm::vec2& vel, unsigned int textureId,
@@ -17,6 +15,4 @@ struct Ball {
     glm::vec2 position;
     unsigned int textureId = 0;
     GameEngine::ColorRGBA8 color;
-	Cell* ownerCell = nullptr;
-	int cellVectorIndex = -1;
 };
@@ -0,0 +1,124 @@
+#include "BallBenchmark.h"
+#include "BallController.h"
+#include "BallStore.h"
+#include "Grid.h"
+#include "MainGame.h"
+
+#include <GameEngine/JobSystem.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <thread>
+#include <vector>
+
+const int BENCHMARK_BALL_COUNTS[] = { 20000, 100000, 1000000 };
+const int GAME_BALLS = 20000; ///< Balls the game spawns on its screen
+const int GAME_WIDTH = 1920;
+const int GAME_HEIGHT = 1080;
+const int WARMUP_STEPS = 10; ///< Untimed steps, the random start positions overlap a lot
+const int TIMED_STEPS = 30;
+const unsigned int BENCHMARK_SEED = 1337;
+
+//Same kind of balls as the game, without the textures
+static void spawnBalls(BallStore& balls, int numBalls, int width, int height){
+	std::mt19937 randomEngine(BENCHMARK_SEED);
+	std::uniform_real_distribution<float> randX(0.0f, (float)width);
+	std::uniform_real_distribution<float> randY(0.0f, (float)height);
+	std::uniform_real_distribution<float> randDir(-1.0f, 1.0f);
+	std::uniform_real_distribution<float> randRadius(2.0f, 6.0f);
+	std::uniform_real_distribution<float> randMass(1.0f, 6.0f);
+	std::uniform_real_distribution<float> randSpeed(0.0f, 3.0f);
+
+	balls.clear();
+	balls.reserve(numBalls);
+	for (int i = 0; i < numBalls; i++)
+	{
+		glm::vec2 pos(randX(randomEngine), randY(randomEngine));
+		glm::vec2 direction(randDir(randomEngine), randDir(randomEngine));
+		if (direction.x != 0.0f || direction.y != 0.0f) {
+			direction = glm::normalize(direction);
+		}
+		else {
+			direction = glm::vec2(1.0f, 0.0f);
+		}
+
+		float radius = randRadius(randomEngine);
+		float mass = randMass(randomEngine);
+		balls.add(Ball(radius, mass, pos, direction * randSpeed(randomEngine), 0,
+			GameEngine::ColorRGBA8(255, 255, 255, 255)));
+	}
+}
+
+void runBallBenchmark(){
+	int maxThreads = std::max((int)std::thread::hardware_concurrency(), 1);
+
+	std::vector<int> threadCounts;
+	for (int numThreads = 1; numThreads < maxThreads; numThreads *= 2)
+	{
+		threadCounts.push_back(numThreads);
+	}
+	threadCounts.push_back(maxThreads);
+
+	BallStore balls;
+	GameEngine::JobSystem jobSystem;
+
+	for (int numBalls : BENCHMARK_BALL_COUNTS)
+	{
+		float scale = std::sqrt((float)numBalls / GAME_BALLS);
+		int width = (int)(GAME_WIDTH * scale);
+		int height = (int)(GAME_HEIGHT * scale);
+
+		//The cell vectors with the scalar collision on one thread are the reference for the speedups
+		double referenceMs = 0.0;
+		for (GridMode gridMode : { GridMode::CELL_VECTORS, GridMode::COUNTING_SORT })
+		for (int run = -1; run < (int)threadCounts.size(); run++)
+		{
+			bool useSimd = run >= 0;
+			int numThreads = useSimd ? threadCounts[run] : 1;
+
+			Grid grid(width, height, CELL_SIZE, gridMode);
+			spawnBalls(balls, numBalls, width, height);
+			grid.update(balls);
+
+			jobSystem.init(numThreads);
+			BallController ballController;
+			ballController.setJobSystem(&jobSystem);
+			ballController.setUseSimd(useSimd);
+			ballController.setGravityDirection(GravityDirection::DOWN);
+
+			for (int step = 0; step < WARMUP_STEPS; step++)
+			{
+				ballController.updateBalls(balls, &grid, 1.0f, width, height);
+			}
+
+			auto start = std::chrono::high_resolution_clock::now();
+			for (int step = 0; step < TIMED_STEPS; step++)
+			{
+				ballController.updateBalls(balls, &grid, 1.0f, width, height);
+			}
+			auto end = std::chrono::high_resolution_clock::now();
+			double stepMs = std::chrono::duration<double, std::milli>(end - start).count() / TIMED_STEPS;
+
+			if (!useSimd && gridMode == GridMode::CELL_VECTORS)
+			{
+				referenceMs = stepMs;
+			}
+
+			double checksum = 0.0;
+			for (int i = 0; i < balls.size(); i++)
+			{
+				glm::vec2 position = balls.getPosition(i);
+				checksum += position.x + position.y;
+			}
+
+			printf("%8d balls  %-13s  %-6s  %2d threads  %9.3f ms/step  %5.2fx  checksum %.3f\n",
+				numBalls, gridMode == GridMode::CELL_VECTORS ? "cell vectors" : "counting sort",
+				useSimd ? "sse" : "scalar", numThreads, stepMs, referenceMs / stepMs, checksum);
+		}
+	}
+
+	jobSystem.destroy();
+}
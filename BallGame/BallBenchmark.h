@@ -0,0 +1,9 @@
+#pragma once
+
+/// Headless timing of BallController::updateBalls, started with "BallGame.exe --benchmark balls".
+/// Runs 20k, 100k and 1M balls on both grid modes, each with the scalar collision on one thread and
+/// then with the SSE collision on 1, 2, 4, ... threads up to one per core, and prints the time per step.
+/// The world grows with the number of balls, so every run has the ball density of the game.
+/// Every run starts from the same balls, so the checksums of one ball count and grid mode have to match.
+/// The grid modes visit the balls of a cell in a different order, so their checksums differ
+void runBallBenchmark();
@@ -1,184 +1,289 @@
 #include "BallController.h"
 #include "Grid.h"
+#include "CollisionCandidates.h"
 
-void BallController::updateBalls(std::vector <Ball>& balls, Grid* grid, float deltaTime, int maxX, int maxY) {
+#include <GameEngine/JobSystem.h>
+#include <algorithm>
+#include <cmath>
+
+const int COLLISION_STRIP_ROWS = 2; ///< Grid rows per strip of the collision pass, at least 2
+
+void BallController::updateBalls(BallStore& balls, Grid* grid, float deltaTime, int maxX, int maxY) {
 	const float FRICTION = 0.001f;
 	// Update our grabbed balls velocity
 	if (m_grabbedBall != -1) {
-		balls[m_grabbedBall].velocity = balls[m_grabbedBall].position - m_prevPos;
+		balls.setVelocity(m_grabbedBall, balls.getPosition(m_grabbedBall) - m_prevPos);
 	}
 
 	glm::vec2 gravity = getGravityAccel();
 
-	for (size_t i = 0; i < balls.size(); i++) {
-		// get handle for less typing
-		Ball& ball = balls[i];
+	for (int i = 0; i < balls.size(); i++) {
+		// Copy the ball out of the columns for less typing
+		glm::vec2 position = balls.getPosition(i);
+		glm::vec2 velocity = balls.getVelocity(i);
+		float radius = balls.m_radii[i];
+		float mass = balls.m_masses[i];
 		// Update motion if its not grabbed
 		if (i != m_grabbedBall) {
-			ball.position += ball.velocity * deltaTime;
+			position += velocity * deltaTime;
 			// Apply friction
-			glm::vec2 momentumVec = ball.velocity * ball.mass;
+			glm::vec2 momentumVec = velocity * mass;
 			if (momentumVec.x != 0 || momentumVec.y != 0) {
 				if (FRICTION < glm::length(momentumVec)) {
-					ball.velocity -= deltaTime * FRICTION * glm::normalize(momentumVec) / ball.mass;
+					velocity -= deltaTime * FRICTION * glm::normalize(momentumVec) / mass;
 				}
 				else {
-					ball.velocity = glm::vec2(0.0f);
+					velocity = glm::vec2(0.0f);
 				}
 			}
 			// Apply gravity
-			ball.velocity += gravity * deltaTime;
+			velocity += gravity * deltaTime;
 		}
 		// Check wall collision
-		if (ball.position.x < ball.radius) {
-			ball.position.x = ball.radius;
-			if (ball.velocity.x < 0) ball.velocity.x *= -1;
+		if (position.x < radius) {
+			position.x = radius;
+			if (velocity.x < 0) velocity.x *= -1;
 		}
-		else if (ball.position.x + ball.radius >= maxX) {
-			ball.position.x = maxX - ball.radius - 1;
-			if (ball.velocity.x > 0) ball.velocity.x *= -1;
+		else if (position.x + radius >= maxX) {
+			position.x = maxX - radius - 1;
+			if (velocity.x > 0) velocity.x *= -1;
 		}
-		if (ball.position.y < ball.radius) {
-			ball.position.y = ball.radius;
-			if (ball.velocity.y < 0) ball.velocity.y *= -1;
+		if (position.y < radius) {
+			position.y = radius;
+			if (velocity.y < 0) velocity.y *= -1;
 		}
-		else if (ball.position.y + ball.radius >= maxY) {
-			ball.position.y = maxY - ball.radius - 1;
-			if (ball.velocity.y > 0) ball.velocity.y *= -1;
-		}
-
-		//Check to see if the ball moved
-		Cell* newCell = grid->getCell(balls[i].position);
-
-		if (newCell != balls[i].ownerCell)
-		{
-			//Need to shift the ball
-			grid->removeBallFromCell(&balls[i]);
-			grid->addBall(&balls[i], newCell);
-
+		else if (position.y + radius >= maxY) {
+			position.y = maxY - radius - 1;
+			if (velocity.y > 0) velocity.y *= -1;
 		}
 
+		balls.setPosition(i, position);
+		balls.setVelocity(i, velocity);
 	}
 
+	//Put the balls into the cells of their new positions
+	grid->update(balls);
+
 	//Update all collisions using the spatial partitioning
-	updateCollision(grid);
+	updateCollision(balls, grid);
 
 	// Update our grabbed ball
 	if (m_grabbedBall != -1) {
 		// Update the velocity again, in case it got changed by collision
-		balls[m_grabbedBall].velocity = balls[m_grabbedBall].position - m_prevPos;
-		m_prevPos = balls[m_grabbedBall].position;
+		balls.setVelocity(m_grabbedBall, balls.getPosition(m_grabbedBall) - m_prevPos);
+		m_prevPos = balls.getPosition(m_grabbedBall);
 	}
 }
 
-void BallController::onMouseDown(std::vector <Ball>& balls, float mouseX, float mouseY) {
-	for (size_t i = 0; i < balls.size(); i++) {
+void BallController::onMouseDown(BallStore& balls, float mouseX, float mouseY) {
+	for (int i = 0; i < balls.size(); i++) {
 		// Check if the mouse is hovering over a ball
-		if (isMouseOnBall(balls[i], mouseX, mouseY)) {
-			m_grabbedBall = i; // BE AWARE, if you change the order of the balls in the vector, this becomes invalid!
-			m_grabOffset = glm::vec2(mouseX, mouseY) - balls[i].position;
-			m_prevPos = balls[i].position;
-			balls[i].velocity = glm::vec2(0.0f);
+		if (isMouseOnBall(balls, i, mouseX, mouseY)) {
+			m_grabbedBall = i; // BE AWARE, if you change the order of the balls in the store, this becomes invalid!
+			m_grabOffset = glm::vec2(mouseX, mouseY) - balls.getPosition(i);
+			m_prevPos = balls.getPosition(i);
+			balls.setVelocity(i, glm::vec2(0.0f));
 		}
 	}
 }
 
-void BallController::onMouseUp(std::vector <Ball>& balls) {
+void BallController::onMouseUp(BallStore& balls) {
 	if (m_grabbedBall != -1) {
 		// Throw the ball!
-		balls[m_grabbedBall].velocity = balls[m_grabbedBall].position - m_prevPos;
+		balls.setVelocity(m_grabbedBall, balls.getPosition(m_grabbedBall) - m_prevPos);
 		m_grabbedBall = -1;
 	}
 }
 
-void BallController::onMouseMove(std::vector <Ball>& balls, float mouseX, float mouseY) {
+void BallController::onMouseMove(BallStore& balls, float mouseX, float mouseY) {
 	if (m_grabbedBall != -1) {
-		balls[m_grabbedBall].position = glm::vec2(mouseX, mouseY) - m_grabOffset;
+		balls.setPosition(m_grabbedBall, glm::vec2(mouseX, mouseY) - m_grabOffset);
 	}
 }
 
-void BallController::updateCollision(Grid* grid){
-	for (size_t i = 0; i < grid->m_cells.size(); i++)
+void BallController::updateCollision(BallStore& balls, Grid* grid){
+	//A cell also moves the balls of the row above and below it, so a strip of at least two rows only shares
+	//balls with the strips right next to it. All even strips can run at once, and then all odd strips.
+	//The order doesn't depend on the number of threads, so every thread count gives the same result
+	int numStrips = (grid->m_numYCells + COLLISION_STRIP_ROWS - 1) / COLLISION_STRIP_ROWS;
+
+	for (int color = 0; color < 2; color++)
+	{
+		int numColorStrips = (numStrips - color + 1) / 2;
+		auto updateStrips = [&](int begin, int end, int){
+			for (int strip = begin; strip < end; strip++)
+			{
+				int firstRow = (strip * 2 + color) * COLLISION_STRIP_ROWS;
+				updateCollision(balls, grid, firstRow, std::min(firstRow + COLLISION_STRIP_ROWS, grid->m_numYCells));
+			}
+		};
+
+		if (m_jobSystem != nullptr)
+		{
+			m_jobSystem->parallelFor(numColorStrips, 1, updateStrips);
+		}
+		else
+		{
+			updateStrips(0, numColorStrips, 0);
+		}
+	}
+}
+
+void BallController::updateCollision(BallStore& balls, Grid* grid, int firstRow, int endRow){
+	if (m_useSimd)
+	{
+		updateCollisionSimd(balls, grid, firstRow, endRow);
+		return;
+	}
+
+	for (int i = firstRow * grid->m_numXCells; i < endRow * grid->m_numXCells; i++)
 	{
 		int x = i % grid->m_numXCells;
 		int y = i / grid->m_numXCells;
 
-		Cell& cell = grid->m_cells[i];
+		CellBalls cell = grid->getCellBalls(x, y);
 
 		//Loop through all balls in a cell
-		for (size_t j = 0; j < cell.balls.size(); j++)
+		for (int j = 0; j < cell.size; j++)
 		{
-			Ball* ball = cell.balls[j];
+			int ball = cell.balls[j];
 			//Update with the residing cell
-			checkCollision(cell.balls[j], cell.balls, j + 1);
+			checkCollision(balls, ball, cell, j + 1);
 
 			//Update collision with neigbor cells
 			if (x > 0)
 			{//Left
-				checkCollision(ball, grid->getCell(x - 1, y)->balls, 0);
+				checkCollision(balls, ball, grid->getCellBalls(x - 1, y), 0);
 				if (y > 0)
 				{
 					//Top left
-					checkCollision(ball, grid->getCell(x - 1, y - 1)->balls, 0);
+					checkCollision(balls, ball, grid->getCellBalls(x - 1, y - 1), 0);
 				}
 				if (y < grid->m_numYCells - 1)
 				{
 					//Bottom left
-					checkCollision(ball, grid->getCell(x - 1, y + 1)->balls, 0);
+					checkCollision(balls, ball, grid->getCellBalls(x - 1, y + 1), 0);
 				}
 			}
 			//Up cell
 			if (y > 0){
-				checkCollision(ball, grid->getCell(x, y - 1)->balls, 0);
+				checkCollision(balls, ball, grid->getCellBalls(x, y - 1), 0);
+			}
+		}
+
+	}
+}
+
+void BallController::updateCollisionSimd(BallStore& balls, Grid* grid, int firstRow, int endRow){
+	CollisionCandidates candidates;
+
+	for (int i = firstRow * grid->m_numXCells; i < endRow * grid->m_numXCells; i++)
+	{
+		int x = i % grid->m_numXCells;
+		int y = i / grid->m_numXCells;
+
+		CellBalls cell = grid->getCellBalls(x, y);
+		if (cell.size == 0)
+		{
+			continue;
+		}
+
+		//Same cells in the same order as the scalar path, the residing cell comes first
+		candidates.clear();
+		candidates.add(cell);
+		if (x > 0)
+		{//Left, top left and bottom left
+			candidates.add(grid->getCellBalls(x - 1, y));
+			if (y > 0)
+			{
+				candidates.add(grid->getCellBalls(x - 1, y - 1));
+			}
+			if (y < grid->m_numYCells - 1)
+			{
+				candidates.add(grid->getCellBalls(x - 1, y + 1));
 			}
 		}
+		//Up cell
+		if (y > 0){
+			candidates.add(grid->getCellBalls(x, y - 1));
+		}
+		candidates.finish(balls);
 
+		//Every ball of the cell checks the candidates after itself
+		for (int j = 0; j < cell.size; j++)
+		{
+			int other = candidates.findOverlap(j, j + 1);
+			while (other != -1)
+			{
+				checkCollision(balls, candidates.getBall(j), candidates.getBall(other));
+				//Both balls may have been pushed
+				candidates.update(balls, j);
+				candidates.update(balls, other);
+				other = candidates.findOverlap(j, other + 1);
+			}
+		}
 	}
 }
 
-void BallController::checkCollision(Ball* ball, std::vector<Ball*>& ballsToCheck, int startingIndex){
-	for (size_t i = startingIndex; i < ballsToCheck.size(); i++)
+void BallController::checkCollision(BallStore& balls, int ball, const CellBalls& ballsToCheck, int startingIndex){
+	for (int i = startingIndex; i < ballsToCheck.size; i++)
 	{
-		checkCollision(*ball, *ballsToCheck[i]);
+		checkCollision(balls, ball, ballsToCheck.balls[i]);
 	}
 }
 
-void BallController::checkCollision(Ball& b1, Ball& b2) {
-	// We add radius since position is the top left corner
-	glm::vec2 distVec = b2.position -
-		b1.position;
-	glm::vec2 distDir = glm::normalize(distVec);
-	float dist = glm::length(distVec);
-	float totalRadius = b1.radius + b2.radius;
+void BallController::checkCollision(BallStore& balls, int b1, int b2) {
+	glm::vec2 position1 = balls.getPosition(b1);
+	glm::vec2 position2 = balls.getPosition(b2);
+	float totalRadius = balls.m_radii[b1] + balls.m_radii[b2];
 
+	glm::vec2 distVec = position2 - position1;
+	// Check for collision with the squared distance, no square root for balls that don't touch
+	float distSquared = distVec.x * distVec.x + distVec.y * distVec.y;
+	if (distSquared >= totalRadius * totalRadius) {
+		return;
+	}
+
+	float dist = std::sqrt(distSquared);
+	// Balls on the same spot get pushed apart sideways
+	glm::vec2 distDir = dist > 0.0f ? distVec / dist : glm::vec2(1.0f, 0.0f);
 	float collisionDepth = totalRadius - dist;
-	// Check for collision
-	if (collisionDepth > 0) {
 
-		// Push away the less massive one
-		if (b1.mass < b2.mass) {
-			b1.position -= distDir * collisionDepth;
-		}
-		else {
-			b2.position += distDir * collisionDepth;
-		}
+	float mass1 = balls.m_masses[b1];
+	float mass2 = balls.m_masses[b2];
+	glm::vec2 velocity1 = balls.getVelocity(b1);
+	glm::vec2 velocity2 = balls.getVelocity(b2);
+
+	// Push away the less massive one
+	if (mass1 < mass2) {
+		position1 -= distDir * collisionDepth;
+	}
+	else {
+		position2 += distDir * collisionDepth;
+	}
 
-		// Calculate deflection. http://stackoverflow.com/a/345863
-		//fixed through comment by Yvo Keuter
-		float aci = glm::dot(b1.velocity, distDir);
-		float bci = glm::dot(b2.velocity, distDir);
+	// Calculate deflection. http://stackoverflow.com/a/345863
+	//fixed through comment by Yvo Keuter
+	float aci = glm::dot(velocity1, distDir);
+	float bci = glm::dot(velocity2, distDir);
 
-		float acf = (aci * (b1.mass - b2.mass) + 2 * b2.mass * bci) / (b1.mass + b2.mass);
-		float bcf = (bci * (b2.mass - b1.mass) + 2 * b1.mass * aci) / (b1.mass + b2.mass);
+	float acf = (aci * (mass1 - mass2) + 2 * mass2 * bci) / (mass1 + mass2);
+	float bcf = (bci * (mass2 - mass1) + 2 * mass1 * aci) / (mass1 + mass2);
 
-		b1.velocity += (acf - aci) * distDir;
-		b2.velocity += (bcf - bci) * distDir;
-	}
+	velocity1 += (acf - aci) * distDir;
+	velocity2 += (bcf - bci) * distDir;
+
+	balls.setPosition(b1, position1);
+	balls.setPosition(b2, position2);
+	balls.setVelocity(b1, velocity1);
+	balls.setVelocity(b2, velocity2);
 }
 
-bool BallController::isMouseOnBall(Ball&b, float mouseX, float mouseY) {
-	return (mouseX >= b.position.x - b.radius && mouseX < b.position.x + b.radius &&
-		mouseY >= b.position.y - b.radius && mouseY < b.position.y + b.radius);
+bool BallController::isMouseOnBall(const BallStore& balls, int b, float mouseX, float mouseY) {
+	glm::vec2 position = balls.getPosition(b);
+	float radius = balls.getRadius(b);
+	return (mouseX >= position.x - radius && mouseX < position.x + radius &&
+		mouseY >= position.y - radius && mouseY < position.y + radius);
 }
 
 glm::vec2 BallController::getGravityAccel() {
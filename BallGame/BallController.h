@@ -2,31 +2,44 @@
 
 #include <vector>
 
-#include "Ball.h"
+#include "BallStore.h"
 
 enum class GravityDirection {NONE, LEFT, UP, RIGHT, DOWN};
 
 class Grid;
+struct CellBalls;
+
+namespace GameEngine{
+	class JobSystem;
+}
 
 class BallController {
 public:
     /// Updates the balls
-    void updateBalls(std::vector <Ball>& balls, Grid* grid, float deltaTime, int maxX, int maxY);
+    void updateBalls(BallStore& balls, Grid* grid, float deltaTime, int maxX, int maxY);
     /// Some simple event functions
-    void onMouseDown(std::vector <Ball>& balls, float mouseX, float mouseY);
-    void onMouseUp(std::vector <Ball>& balls);
-    void onMouseMove(std::vector <Ball>& balls, float mouseX, float mouseY);
+    void onMouseDown(BallStore& balls, float mouseX, float mouseY);
+    void onMouseUp(BallStore& balls);
+    void onMouseMove(BallStore& balls, float mouseX, float mouseY);
     void setGravityDirection(GravityDirection dir) { m_gravityDirection = dir; }
+    /// The collision runs on the job system, nullptr = everything on the calling thread
+    void setJobSystem(GameEngine::JobSystem* jobSystem) { m_jobSystem = jobSystem; }
+    /// true = filter the pairs with SSE first. Off by default, "--benchmark balls" showed no consistent win over the scalar path
+    void setUseSimd(bool useSimd) { m_useSimd = useSimd; }
 private:
 	//Updates collision
-	void updateCollision(Grid* grid);
+	void updateCollision(BallStore& balls, Grid* grid);
+	///Collision of the cells in the rows [firstRow, endRow), also moves balls of the row above and below
+	void updateCollision(BallStore& balls, Grid* grid, int firstRow, int endRow);
+	///Same as updateCollision, but only calls checkCollision for the pairs the SSE test finds overlapping
+	void updateCollisionSimd(BallStore& balls, Grid* grid, int firstRow, int endRow);
 	///Checks collision between a ball and a vector of balls, starting at a specific index
-	void checkCollision(Ball* ball, std::vector<Ball*>& ballsToCheck, int startingIndex);
+	void checkCollision(BallStore& balls, int ball, const CellBalls& ballsToCheck, int startingIndex);
     /// Checks collision between two balls
-	void checkCollision(Ball& b1, Ball& b2);
+	void checkCollision(BallStore& balls, int b1, int b2);
 
     /// Returns true if the mouse is hovering over a ball
-    bool isMouseOnBall(Ball&b, float mouseX, float mouseY);
+    bool isMouseOnBall(const BallStore& balls, int b, float mouseX, float mouseY);
     glm::vec2 getGravityAccel();
 
     int m_grabbedBall = -1; ///< The ball we are currently grabbing on to
@@ -34,5 +47,8 @@ private:
     glm::vec2 m_grabOffset = glm::vec2(0.0f); ///< Offset of the cursor on the selected ball
 
     GravityDirection m_gravityDirection = GravityDirection::NONE;
+
+    GameEngine::JobSystem* m_jobSystem = nullptr;
+    bool m_useSimd = false;
 };
 
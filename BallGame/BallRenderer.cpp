@@ -1,20 +1,41 @@
 #include "BallRenderer.h"
 
+namespace {
+
+	//Compiles the texture program that matches the way the sprite batch uploads its sprites
+	std::unique_ptr<GameEngine::GLSLProgram> createBallProgram(const GameEngine::SpriteBatch& spriteBatch) {
+		auto program = std::make_unique<GameEngine::GLSLProgram>();
+		if (spriteBatch.getMode() == GameEngine::SpriteBatchMode::INSTANCED)
+		{
+			program->compileShaders("Shaders/instancedShading.vert", "Shaders/textureShading.frag");
+			program->addAttribute("instanceDestRect");
+			program->addAttribute("instanceUVRect");
+			program->addAttribute("instanceColor");
+			program->addAttribute("instanceAngleDepth");
+		}
+		else
+		{
+			program->compileShaders("Shaders/textureShading.vert", "Shaders/textureShading.frag");
+			program->addAttribute("vertexPosition");
+			program->addAttribute("vertexColor");
+			program->addAttribute("vertexUV");
+		}
+		program->linkShaders();
+		return program;
+	}
+
+}
+
 void  BallRenderer::renderBalls(
 	GameEngine::SpriteBatch& spriteBatch,
-	const std::vector<Ball>& balls,
+	const BallStore& balls,
 	const glm::mat4& projectionMatrix) {
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
 	//Lazily initialize the program
 	if (m_program == nullptr)
 	{
-		m_program = std::make_unique<GameEngine::GLSLProgram>();
-		m_program->compileShaders("Shaders/textureShading.vert", "Shaders/textureShading.frag");
-		m_program->addAttribute("vertexPosition");
-		m_program->addAttribute("vertexColor");
-		m_program->addAttribute("vertexUV");
-		m_program->linkShaders();
+		m_program = createBallProgram(spriteBatch);
 	}
 
 	m_program->use();
@@ -29,8 +50,9 @@ void  BallRenderer::renderBalls(
 	glUniformMatrix4fv(pUniform, 1, GL_FALSE, &projectionMatrix[0][0]);
 
 	//Render all the balls
-	for (auto& ball : balls)
+	for (int i = 0; i < balls.size(); i++)
 	{
+		const Ball ball = balls.getBall(i);
 		const glm::vec4 uvRect(0.0f, 0.0f, 1.0f, 1.0f);
 		const glm::vec4 destRect(ball.position.x - ball.radius, ball.position.y - ball.radius,
 			ball.radius * 2.0f, ball.radius * 2.0f);
@@ -47,7 +69,7 @@ void  BallRenderer::renderBalls(
 
 void  MomentumBallRenderer::renderBalls(
 	GameEngine::SpriteBatch& spriteBatch,
-	const std::vector<Ball>& balls,
+	const BallStore& balls,
 	const glm::mat4& projectionMatrix) {
 
 	glClearColor(0.0f, 0.1f, 0.5f, 1.0f);
@@ -55,12 +77,7 @@ void  MomentumBallRenderer::renderBalls(
 	//Lazily initialize the program
 	if (m_program == nullptr)
 	{
-		m_program = std::make_unique<GameEngine::GLSLProgram>();
-		m_program->compileShaders("Shaders/textureShading.vert", "Shaders/textureShading.frag");
-		m_program->addAttribute("vertexPosition");
-		m_program->addAttribute("vertexColor");
-		m_program->addAttribute("vertexUV");
-		m_program->linkShaders();
+		m_program = createBallProgram(spriteBatch);
 	}
 
 	m_program->use();
@@ -75,8 +92,9 @@ void  MomentumBallRenderer::renderBalls(
 	glUniformMatrix4fv(pUniform, 1, GL_FALSE, &projectionMatrix[0][0]);
 
 	//Render all the balls
-	for (auto& ball : balls)
+	for (int i = 0; i < balls.size(); i++)
 	{
+		const Ball ball = balls.getBall(i);
 		const glm::vec4 uvRect(0.0f, 0.0f, 1.0f, 1.0f);
 		const glm::vec4 destRect(ball.position.x - ball.radius, ball.position.y - ball.radius,
 			ball.radius * 2.0f, ball.radius * 2.0f);
@@ -103,7 +121,7 @@ VelocityBallRenderer::VelocityBallRenderer(int screenWidth, int screenHeight) :
 
 void VelocityBallRenderer::renderBalls(
 	GameEngine::SpriteBatch& spriteBatch,
-	const std::vector<Ball>& balls,
+	const BallStore& balls,
 	const glm::mat4& projectionMatrix) {
 
 		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
@@ -111,12 +129,7 @@ void VelocityBallRenderer::renderBalls(
 		//Lazily initialize the program
 		if (m_program == nullptr)
 		{
-			m_program = std::make_unique<GameEngine::GLSLProgram>();
-			m_program->compileShaders("Shaders/textureShading.vert", "Shaders/textureShading.frag");
-			m_program->addAttribute("vertexPosition");
-			m_program->addAttribute("vertexColor");
-			m_program->addAttribute("vertexUV");
-			m_program->linkShaders();
+			m_program = createBallProgram(spriteBatch);
 		}
 
 		m_program->use();
@@ -131,8 +144,9 @@ void VelocityBallRenderer::renderBalls(
 		glUniformMatrix4fv(pUniform, 1, GL_FALSE, &projectionMatrix[0][0]);
 
 		//Render all the balls
-		for (auto& ball : balls)
+		for (int i = 0; i < balls.size(); i++)
 		{
+			const Ball ball = balls.getBall(i);
 			const glm::vec4 uvRect(0.0f, 0.0f, 1.0f, 1.0f);
 			const glm::vec4 destRect(ball.position.x - ball.radius, ball.position.y - ball.radius,
 				ball.radius * 2.0f, ball.radius * 2.0f);
@@ -166,18 +180,13 @@ m_screenHeight(screenHeight) {
 	// Empty
 }
 
-void TrippyBallRenderer::renderBalls(GameEngine::SpriteBatch& spriteBatch, const std::vector<Ball>& balls, const glm::mat4& projectionMatrix)
+void TrippyBallRenderer::renderBalls(GameEngine::SpriteBatch& spriteBatch, const BallStore& balls, const glm::mat4& projectionMatrix)
 {
 	glClearColor(0.1f, 0.0f, 0.0f, 1.0f);
 
 	// Lazily initialize the program
 	if (m_program == nullptr) {
-		m_program = std::make_unique<GameEngine::GLSLProgram>();
-		m_program->compileShaders("Shaders/textureShading.vert", "Shaders/textureShading.frag");
-		m_program->addAttribute("vertexPosition");
-		m_program->addAttribute("vertexColor");
-		m_program->addAttribute("vertexUV");
-		m_program->linkShaders();
+		m_program = createBallProgram(spriteBatch);
 	}
 	m_program->use();
 
@@ -200,7 +209,8 @@ void TrippyBallRenderer::renderBalls(GameEngine::SpriteBatch& spriteBatch, const
 	m_time += TIME_SPEED;
 
 	// Render all the balls
-	for (auto& ball : balls) {
+	for (int i = 0; i < balls.size(); i++) {
+		const Ball ball = balls.getBall(i);
 		const glm::vec4 uvRect(0.0f, 0.0f, 1.0f, 1.0f);
 		const glm::vec4 destRect(ball.position.x - ball.radius, ball.position.y - ball.radius,
 			ball.radius * 2.0f, ball.radius * 2.0f);
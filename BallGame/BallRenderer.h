@@ -4,7 +4,7 @@
 #include <vector>
 #include <memory>
 
-#include "Ball.h"
+#include "BallStore.h"
 
 // Ball renderer interface
 class BallRenderer {
@@ -13,7 +13,7 @@ public:
    /* void renderBall(GameEngine::SpriteBatch& spriteBatch, Ball& ball);*/
 	virtual void renderBalls(
 		GameEngine::SpriteBatch& spriteBatch,
-		const std::vector<Ball>& balls,
+		const BallStore& balls,
 		const glm::mat4& projectionMatrix);
 
 protected:
@@ -27,7 +27,7 @@ class MomentumBallRenderer : public BallRenderer
 public:
 	virtual void renderBalls(
 		GameEngine::SpriteBatch& spriteBatch,
-		const std::vector<Ball>& balls,
+		const BallStore& balls,
 		const glm::mat4& projectionMatrix) override;
 };
 
@@ -38,7 +38,7 @@ public:
 	VelocityBallRenderer(int screenWidth, int screenHeight);
 	virtual void renderBalls(
 		GameEngine::SpriteBatch& spriteBatch,
-		const std::vector<Ball>& balls,
+		const BallStore& balls,
 		const glm::mat4& projectionMatrix) override;
 private:
 	int m_screenWidth;
@@ -54,7 +54,7 @@ public:
 
 	virtual void renderBalls(
 		GameEngine::SpriteBatch& spriteBatch, 
-		const std::vector<Ball>& balls, 
+		const BallStore& balls, 
 		const glm::mat4& projectionMatrix) override;
 private:
 	int m_screenWidth;
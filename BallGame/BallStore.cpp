@@ -0,0 +1,61 @@
+#include "BallStore.h"
+
+
+BallStore::BallStore()
+{
+}
+
+
+BallStore::~BallStore()
+{
+}
+
+void BallStore::reserve(int numBalls){
+	m_positionsX.reserve(numBalls);
+	m_positionsY.reserve(numBalls);
+	m_velocitiesX.reserve(numBalls);
+	m_velocitiesY.reserve(numBalls);
+	m_radii.reserve(numBalls);
+	m_masses.reserve(numBalls);
+	m_textureIds.reserve(numBalls);
+	m_colors.reserve(numBalls);
+}
+
+void BallStore::clear(){
+	m_positionsX.clear();
+	m_positionsY.clear();
+	m_velocitiesX.clear();
+	m_velocitiesY.clear();
+	m_radii.clear();
+	m_masses.clear();
+	m_textureIds.clear();
+	m_colors.clear();
+}
+
+int BallStore::add(const Ball& ball){
+	m_positionsX.push_back(ball.position.x);
+	m_positionsY.push_back(ball.position.y);
+	m_velocitiesX.push_back(ball.velocity.x);
+	m_velocitiesY.push_back(ball.velocity.y);
+	m_radii.push_back(ball.radius);
+	m_masses.push_back(ball.mass);
+	m_textureIds.push_back(ball.textureId);
+	m_colors.push_back(ball.color);
+
+	return m_positionsX.size() - 1;
+}
+
+Ball BallStore::getBall(int index) const {
+	return Ball(m_radii[index], m_masses[index], getPosition(index), getVelocity(index),
+		m_textureIds[index], m_colors[index]);
+}
+
+void BallStore::setPosition(int index, const glm::vec2& position){
+	m_positionsX[index] = position.x;
+	m_positionsY[index] = position.y;
+}
+
+void BallStore::setVelocity(int index, const glm::vec2& velocity){
+	m_velocitiesX[index] = velocity.x;
+	m_velocitiesY[index] = velocity.y;
+}
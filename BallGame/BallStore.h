@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <GameEngine/Vertex.h>
+#include <vector>
+
+#include "Ball.h"
+
+/// All balls, stored column by column (structure of arrays), so the collision kernel can
+/// load the positions and radii of several balls at once.
+/// A ball is just an index into the columns, balls are never removed so indices stay valid
+class BallStore
+{
+	friend class BallController;
+	friend class ChangeColorBallController;
+	friend class CollisionCandidates;
+public:
+	BallStore();
+	~BallStore();
+
+	void reserve(int numBalls);
+
+	void clear();
+
+	/// Adds the ball and returns its index
+	int add(const Ball& ball);
+
+	/// Copy of the ball at index
+	Ball getBall(int index) const;
+
+	int size() const { return m_positionsX.size(); }
+
+	glm::vec2 getPosition(int index) const { return glm::vec2(m_positionsX[index], m_positionsY[index]); }
+	glm::vec2 getVelocity(int index) const { return glm::vec2(m_velocitiesX[index], m_velocitiesY[index]); }
+	float getRadius(int index) const { return m_radii[index]; }
+
+	void setPosition(int index, const glm::vec2& position);
+	void setVelocity(int index, const glm::vec2& velocity);
+
+private:
+	//The columns, all of the same length
+	std::vector<float> m_positionsX; ///< Center
+	std::vector<float> m_positionsY;
+	std::vector<float> m_velocitiesX;
+	std::vector<float> m_velocitiesY;
+	std::vector<float> m_radii;
+	std::vector<float> m_masses;
+	std::vector<unsigned int> m_textureIds;
+	std::vector<GameEngine::ColorRGBA8> m_colors;
+};
@@ -0,0 +1,88 @@
+#include "CollisionCandidates.h"
+#include "BallStore.h"
+#include "Grid.h"
+
+#include <xmmintrin.h>
+#include <limits>
+
+const int SIMD_WIDTH = 4; ///< Candidates per SSE register
+
+
+CollisionCandidates::CollisionCandidates()
+{
+}
+
+
+CollisionCandidates::~CollisionCandidates()
+{
+}
+
+void CollisionCandidates::clear(){
+	m_numCandidates = 0;
+	m_balls.clear();
+}
+
+void CollisionCandidates::add(const CellBalls& cellBalls){
+	m_balls.insert(m_balls.end(), cellBalls.balls, cellBalls.balls + cellBalls.size);
+}
+
+void CollisionCandidates::finish(const BallStore& balls){
+	m_numCandidates = m_balls.size();
+	if ((int)m_positionsX.size() < m_numCandidates + SIMD_WIDTH - 1)
+	{
+		m_positionsX.resize(m_numCandidates + SIMD_WIDTH - 1);
+		m_positionsY.resize(m_numCandidates + SIMD_WIDTH - 1);
+		m_radii.resize(m_numCandidates + SIMD_WIDTH - 1);
+	}
+
+	for (int i = 0; i < m_numCandidates; i++)
+	{
+		int ball = m_balls[i];
+		m_positionsX[i] = balls.m_positionsX[ball];
+		m_positionsY[i] = balls.m_positionsY[ball];
+		m_radii[i] = balls.m_radii[ball];
+	}
+
+	//Padding is infinitely far away, so its squared distance is never smaller than a squared radius
+	for (int i = m_numCandidates; i < m_numCandidates + SIMD_WIDTH - 1; i++)
+	{
+		m_positionsX[i] = std::numeric_limits<float>::infinity();
+		m_positionsY[i] = 0.0f;
+		m_radii[i] = 0.0f;
+	}
+}
+
+void CollisionCandidates::update(const BallStore& balls, int candidate){
+	glm::vec2 position = balls.getPosition(m_balls[candidate]);
+	m_positionsX[candidate] = position.x;
+	m_positionsY[candidate] = position.y;
+}
+
+int CollisionCandidates::findOverlap(int candidate, int first) const {
+	__m128 x = _mm_set1_ps(m_positionsX[candidate]);
+	__m128 y = _mm_set1_ps(m_positionsY[candidate]);
+	__m128 radius = _mm_set1_ps(m_radii[candidate]);
+
+	for (int i = first; i < m_numCandidates; i += SIMD_WIDTH)
+	{
+		//Same operations in the same order as the scalar check, so both agree on every pair
+		__m128 distX = _mm_sub_ps(_mm_loadu_ps(&m_positionsX[i]), x);
+		__m128 distY = _mm_sub_ps(_mm_loadu_ps(&m_positionsY[i]), y);
+		__m128 distSquared = _mm_add_ps(_mm_mul_ps(distX, distX), _mm_mul_ps(distY, distY));
+		__m128 totalRadius = _mm_add_ps(radius, _mm_loadu_ps(&m_radii[i]));
+		int mask = _mm_movemask_ps(_mm_cmplt_ps(distSquared, _mm_mul_ps(totalRadius, totalRadius)));
+
+		if (mask != 0)
+		{
+			//The padding never overlaps, so the lowest bit is a real candidate
+			int lane = 0;
+			while ((mask & (1 << lane)) == 0)
+			{
+				lane++;
+			}
+			return i + lane;
+		}
+	}
+
+	return -1;
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <vector>
+
+class BallStore;
+struct CellBalls;
+
+/// The balls of a cell and its neighbor cells, copied into contiguous arrays so the overlap test can
+/// check four candidates at once with SSE. The test only compares squared distances, so the
+/// square roots and the deflection are left to the controllers for the few balls that really overlap.
+/// After a controller moved a ball it has to call update, so later tests see the new position
+class CollisionCandidates
+{
+public:
+	CollisionCandidates();
+	~CollisionCandidates();
+
+	/// Removes all candidates, the arrays keep their memory
+	void clear();
+
+	/// Appends the balls of a cell to the candidates
+	void add(const CellBalls& cellBalls);
+
+	/// Copies the positions and radii of the candidates and pads them, call it once after adding them
+	void finish(const BallStore& balls);
+
+	/// Copies the position of the candidate again
+	void update(const BallStore& balls, int candidate);
+
+	/// Returns the first candidate at or after first that overlaps candidate, -1 = none
+	int findOverlap(int candidate, int first) const;
+
+	int size() const { return m_numCandidates; }
+	/// Index of the candidate in the BallStore
+	int getBall(int candidate) const { return m_balls[candidate]; }
+
+private:
+	int m_numCandidates = 0;
+	std::vector<int> m_balls;
+	//Candidates and padding, the test may read up to three floats past the last candidate
+	std::vector<float> m_positionsX;
+	std::vector<float> m_positionsY;
+	std::vector<float> m_radii;
+};
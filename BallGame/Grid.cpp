@@ -1,7 +1,10 @@
 #include "Grid.h"
 
+#include <algorithm>
 
-Grid::Grid(int width, int height, int cellSize) : 
+
+Grid::Grid(int width, int height, int cellSize, GridMode mode) :
+m_mode(mode),
 m_width(width),
 m_height(height), 
 m_cellSize(cellSize)
@@ -9,12 +12,19 @@ m_cellSize(cellSize)
 	m_numXCells = ceil((float)m_width / m_cellSize);
 	m_numYCells = ceil((float)m_height / m_cellSize);
 
-	//Allocate all the cells
-	const int BALLS_TO_RESERVE = 20;
-	m_cells.resize(m_numYCells * m_numXCells);
-	for (size_t i = 0; i < m_cells.size(); i++)
+	if (m_mode == GridMode::CELL_VECTORS)
+	{
+		//Allocate all the cells
+		const int BALLS_TO_RESERVE = 20;
+		m_cells.resize(m_numYCells * m_numXCells);
+		for (size_t i = 0; i < m_cells.size(); i++)
+		{
+			m_cells[i].balls.reserve(BALLS_TO_RESERVE);
+		}
+	}
+	else
 	{
-		m_cells[i].balls.reserve(BALLS_TO_RESERVE);
+		m_spatialGrid.init(glm::vec2(0.0f), glm::vec2(m_width, m_height), (float)m_cellSize);
 	}
 }
 
@@ -23,20 +33,42 @@ Grid::~Grid()
 {
 }
 
-void Grid::addBall(Ball* ball){
-	Cell* cell = getCell(ball->position);
-	cell->balls.push_back(ball);
-	ball->ownerCell = cell;
-	ball->cellVectorIndex = cell->balls.size() - 1;
+void Grid::update(const BallStore& balls){
+	if (m_mode == GridMode::CELL_VECTORS)
+	{
+		moveBalls(balls);
+	}
+	else
+	{
+		m_spatialGrid.clear();
+		for (int i = 0; i < balls.size(); i++)
+		{
+			m_spatialGrid.add(glm::vec4(balls.getPosition(i), 0.0f, 0.0f));
+		}
+		m_spatialGrid.build();
+	}
 }
 
-void Grid::addBall(Ball* ball, Cell* cell){
-	cell->balls.push_back(ball);
-	ball->ownerCell = cell;
-	ball->cellVectorIndex = cell->balls.size() - 1;
+CellBalls Grid::getCellBalls(int x, int y) const {
+	CellBalls cellBalls;
+	int cell = y * m_numXCells + x;
+
+	if (m_mode == GridMode::CELL_VECTORS)
+	{
+		cellBalls.balls = m_cells[cell].balls.data();
+		cellBalls.size = m_cells[cell].balls.size();
+	}
+	else
+	{
+		cellBalls.balls = m_spatialGrid.getCellBoxes(x, y, cellBalls.size);
+	}
+	return cellBalls;
 }
 
-Cell* Grid::getCell(int x, int y){
+int Grid::getCellIndex(const glm::vec2& position) const {
+	int x = (int)(position.x / m_cellSize);
+	int y = (int)(position.y / m_cellSize);
+
 	if (x < 0)
 	{
 		x = 0;
@@ -55,28 +87,48 @@ Cell* Grid::getCell(int x, int y){
 		y = m_numYCells - 1;
 	}
 
-	return &m_cells[y * m_numXCells + x];
-
+	return y * m_numXCells + x;
 }
 
-Cell* Grid::getCell(const glm::vec2& position){
-	int cellX = (int)(position.x / m_cellSize);
-	int cellY = (int)(position.y / m_cellSize);
+void Grid::moveBalls(const BallStore& balls){
+	for (int i = 0; i < balls.size(); i++)
+	{
+		int newCell = getCellIndex(balls.getPosition(i));
 
-	return getCell(cellX, cellY);
+		if (i >= (int)m_ballCells.size())
+		{
+			//New ball
+			m_ballCells.push_back(-1);
+			m_ballCellIndices.push_back(-1);
+			addBall(i, newCell);
+		}
+		else if (newCell != m_ballCells[i])
+		{
+			//Need to shift the ball
+			removeBallFromCell(i);
+			addBall(i, newCell);
+		}
+	}
+}
+
+void Grid::addBall(int ball, int cell){
+	m_cells[cell].balls.push_back(ball);
+	m_ballCells[ball] = cell;
+	m_ballCellIndices[ball] = m_cells[cell].balls.size() - 1;
 }
 
-void Grid::removeBallFromCell(Ball* ball){
-	std::vector<Ball*>& balls = ball->ownerCell->balls;
+void Grid::removeBallFromCell(int ball){
+	std::vector<int>& balls = m_cells[m_ballCells[ball]].balls;
+	int cellIndex = m_ballCellIndices[ball];
 	//Normal vector swap
-	balls[ball->cellVectorIndex] = balls.back();
+	balls[cellIndex] = balls.back();
 	balls.pop_back();
 	//Update vector index
-	if (ball->cellVectorIndex < balls.size())
+	if (cellIndex < balls.size())
 	{
-		balls[ball->cellVectorIndex]->cellVectorIndex = ball->cellVectorIndex;
+		m_ballCellIndices[balls[cellIndex]] = cellIndex;
 	}
 	//Set the index of ball to -1
-	ball->cellVectorIndex = -1;
-	ball->ownerCell = nullptr;
-}
\ No newline at end of file
+	m_ballCellIndices[ball] = -1;
+	m_ballCells[ball] = -1;
+}
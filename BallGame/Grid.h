@@ -1,42 +1,68 @@
 #pragma once
-#include "Ball.h"
+#include <GameEngine/SpatialGrid.h>
+#include <glm/glm.hpp>
 #include <vector>
 
+#include "BallStore.h"
+
 struct Cell
 {
-	std::vector<Ball*> balls;
+	std::vector<int> balls; ///< Indices into the BallStore
 
 
 };
 
+/// The balls of one cell, valid until the next update of the grid
+struct CellBalls
+{
+	const int* balls = nullptr; ///< Indices into the BallStore
+	int size = 0;
+};
 
+enum class GridMode{
+	CELL_VECTORS, ///< Every cell owns a vector, balls that change their cell get moved between them
+	COUNTING_SORT ///< Rebuilt every update by a GameEngine::SpatialGrid, all cells share one array of ball indices sorted by cell
+};
 
 class Grid
 {
 	friend class BallController;
 	friend class ChangeColorBallController;
 public:
-	Grid(int width, int height, int cellSize);
+	Grid(int width, int height, int cellSize, GridMode mode = GridMode::COUNTING_SORT);
 	~Grid();
 
-	//Adds a ball an determines which cell it belongs to
-	void addBall(Ball* ball);
-	//Adds a ball to the specified cell
-	void addBall(Ball* ball, Cell* cell);
+	/// Puts every ball into the cell of its current position, call it after moving the balls.
+	/// Balls added to the store since the last update are added to the grid
+	void update(const BallStore& balls);
 
-	//Get Cell based on cell coordinates
-	Cell* getCell(int x, int y);
-	//get Cell based on window coordinates
-	Cell* getCell(const glm::vec2& position);
+	//Get the balls of a cell based on cell coordinates
+	CellBalls getCellBalls(int x, int y) const;
 
-	void removeBallFromCell(Ball* ball);
+	GridMode getMode() const { return m_mode; }
 
 private:
-	std::vector<Cell> m_cells;
+	//Cell index based on window coordinates
+	int getCellIndex(const glm::vec2& position) const;
+
+	//GridMode::CELL_VECTORS
+	void moveBalls(const BallStore& balls);
+	void addBall(int ball, int cell);
+	void removeBallFromCell(int ball);
+
+	GridMode m_mode;
 	int m_cellSize;
 	int m_width;
 	int m_height;
 	int m_numXCells;
 	int m_numYCells;
+
+	//GridMode::CELL_VECTORS, the per ball vectors are indexed like the BallStore
+	std::vector<Cell> m_cells;
+	std::vector<int> m_ballCells; ///< Cell of every ball
+	std::vector<int> m_ballCellIndices; ///< Index of every ball in the vector of its cell
+
+	//GridMode::COUNTING_SORT, every ball is a point box whose id is its index in the BallStore
+	GameEngine::SpatialGrid m_spatialGrid;
 };
 
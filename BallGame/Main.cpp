@@ -1,8 +1,32 @@
 #include "MainGame.h"
+#include "BallBenchmark.h"
+#include "SpriteBatchBenchmark.h"
+
+#include <GameEngine/IOManager.h>
+
+#include <cstring>
 
 int main(int argc, char** argv) {
+    //Release builds ship their assets in one pack, without it the loose files are used
+    GameEngine::IOManager::mountPack("Assets.pak");
+
+    //"--benchmark" runs all of them, "--benchmark balls" only one
+    if (argc > 1 && strcmp(argv[1], "--benchmark") == 0) {
+        const char* name = argc > 2 ? argv[2] : "";
+        if (name[0] == '\0' || strcmp(name, "balls") == 0) {
+            runBallBenchmark();
+        }
+        if (name[0] == '\0' || strcmp(name, "sprites") == 0) {
+            runSpriteBatchBenchmark();
+        }
+        if (name[0] == '\0' || strcmp(name, "sort") == 0) {
+            runSpriteSortBenchmark();
+        }
+        return 0;
+    }
+
     MainGame mainGame;
     mainGame.run();
 
     return 0;
-}
\ No newline at end of file
+}
@@ -22,6 +22,9 @@ MainGame::~MainGame(){
 	{
 		delete m_ballRenderers[i];
 	}
+
+	m_spriteBatch.dispose();
+	m_ballSpriteBatch.dispose();
 }
 
 void MainGame::run() {
@@ -77,6 +80,13 @@ void MainGame::init() {
 	m_camera.setPosition(glm::vec2(m_screenWidth / 2.0f, m_screenHeight / 2.0f));
 
 	m_spriteBatch.init();
+	// The balls only need one small record per sprite when the driver supports instancing
+	if (GameEngine::SpriteBatch::isInstancingSupported()) {
+		m_ballSpriteBatch.init(GameEngine::SpriteBatchMode::INSTANCED);
+	}
+	else {
+		m_ballSpriteBatch.init();
+	}
 	// Initialize sprite font
 	m_spriteFont = std::make_unique<GameEngine::SpriteFont>("Fonts/chintzy.ttf", 40);
 
@@ -89,6 +99,9 @@ void MainGame::init() {
 
 	m_fpsLimiter.setMaxFPS(60.0f);
 
+	m_jobSystem.init(NUM_COLLISION_THREADS);
+	m_ballController.setJobSystem(&m_jobSystem);
+
 	initRenderers();
 
 }
@@ -199,13 +212,14 @@ void MainGame::initBalls() {
 		}
 
 		// Add ball
-		m_balls.emplace_back(ballToSpawn->radius, ballToSpawn->mass, pos, direction * ballToSpawn->randSpeed(randomEngine),
+		m_balls.add(Ball(ballToSpawn->radius, ballToSpawn->mass, pos, direction * ballToSpawn->randSpeed(randomEngine),
 			GameEngine::ResourceManager::getTexture("Textures/circle.png").id,
-			ballToSpawn->color);
+			ballToSpawn->color));
 
-		//Add the ball to the grid. IF YOU CALL EMPLACE BACK AFTER INIT BALLS, m_grid will have DANGLING POINTERS
-		m_grid->addBall(&m_balls.back());
 	}
+
+	//Put the balls into the grid
+	m_grid->update(m_balls);
 }
 
 void MainGame::update(float deltaTime) {
@@ -224,7 +238,7 @@ void MainGame::draw() {
 	glm::mat4 projectionMatrix = m_camera.getCameraMatrix();
 
 	// Draw balls
-	m_ballRenderers[m_currentRenderer]->renderBalls(m_spriteBatch, m_balls, projectionMatrix);
+	m_ballRenderers[m_currentRenderer]->renderBalls(m_ballSpriteBatch, m_balls, projectionMatrix);
 
 	m_textureProgram.use();
 
@@ -246,7 +260,9 @@ void MainGame::drawHud() {
 	const GameEngine::ColorRGBA8 fontColor(255, 0, 0, 255);
 	// Convert float to char *
 	char buffer[64];
-	sprintf(buffer, "%.1f", m_fps);
+	//The p99 frame time shows stutter the average fps hide
+	GameEngine::FrameTimeStats frameTimes = m_fpsLimiter.getFrameTimeStats();
+	sprintf(buffer, "%.1f  p99 %.1f ms  %d KB", m_fps, frameTimes.p99, (int)(m_ballSpriteBatch.getUploadedBytes() / 1024));
 
 	m_spriteBatch.begin();
 	m_spriteFont->draw(m_spriteBatch, buffer, glm::vec2(0.0f, m_screenHeight - 32.0f),
@@ -7,6 +7,7 @@
 #include <GameEngine/GLSLProgram.h>
 #include <GameEngine/Timing.h>
 #include <GameEngine/SpriteFont.h>
+#include <GameEngine/JobSystem.h>
 #include <memory>
 
 #include "ChangeColorBallController.h"
@@ -16,6 +17,7 @@
 enum class GameState { RUNNING, EXIT };
 
 const int CELL_SIZE = 12;
+const int NUM_COLLISION_THREADS = 0; ///< Threads of the collision pass, 0 = one per core
 
 
 class MainGame {
@@ -35,16 +37,18 @@ private:
     int m_screenWidth = 0;
     int m_screenHeight = 0;
 
-    std::vector<Ball> m_balls; ///< All the balls
+    BallStore m_balls; ///< All the balls
 	std::unique_ptr<Grid> m_grid; ///< Grid for spatial partitioning for collision
 
 	int m_currentRenderer = 0;
 	std::vector<BallRenderer*> m_ballRenderers;
 
     ChangeColorBallController m_ballController; ///< Controls balls
+    GameEngine::JobSystem m_jobSystem; ///< Runs the collision pass
 
     GameEngine::Window m_window; ///< The main window
-    GameEngine::SpriteBatch m_spriteBatch; ///< Renders all the balls
+    GameEngine::SpriteBatch m_spriteBatch; ///< Renders the HUD
+    GameEngine::SpriteBatch m_ballSpriteBatch; ///< Renders all the balls, instanced if supported
     std::unique_ptr<GameEngine::SpriteFont> m_spriteFont; ///< For font rendering
     GameEngine::Camera2D m_camera; ///< Renders the scene
     GameEngine::InputManager m_inputManager; ///< Handles input
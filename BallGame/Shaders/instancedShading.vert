@@ -0,0 +1,45 @@
+#version 130
+//The vertex shader operates on each vertex
+
+//input data from the VBO. Every attribute is per sprite, not per vertex
+in vec4 instanceDestRect;
+in vec4 instanceUVRect;
+in vec4 instanceColor;
+in vec2 instanceAngleDepth;
+
+out vec2 fragmentPosition;
+out vec4 fragmentColor;
+out vec2 fragmentUV;
+
+uniform mat4 P;
+
+//Corners of the two triangles: topLeft, bottomLeft, bottomRight, bottomRight, topRight, topLeft
+const vec2 CORNERS[6] = vec2[6](
+    vec2(0.0, 1.0), vec2(0.0, 0.0), vec2(1.0, 0.0),
+    vec2(1.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0));
+
+void main() {
+    vec2 corner = CORNERS[gl_VertexID];
+    vec2 halfDims = instanceDestRect.zw * 0.5;
+
+    //Rotate around the center of the sprite
+    float s = sin(instanceAngleDepth.x);
+    float c = cos(instanceAngleDepth.x);
+    vec2 local = (corner - 0.5) * instanceDestRect.zw;
+    vec2 vertexPosition = vec2(local.x * c - local.y * s, local.x * s + local.y * c) + halfDims + instanceDestRect.xy;
+
+    //Set the x,y position on the screen
+    gl_Position.xy = (P * vec4(vertexPosition, 0.0, 1.0)).xy;
+    //the z position is zero since we are in 2D
+    gl_Position.z = 0.0;
+
+    //Indicate that the coordinates are normalized
+    gl_Position.w = 1.0;
+
+    fragmentPosition = vertexPosition;
+
+    fragmentColor = instanceColor;
+
+    vec2 vertexUV = instanceUVRect.xy + corner * instanceUVRect.zw;
+    fragmentUV = vec2(vertexUV.x, 1.0 - vertexUV.y);
+}
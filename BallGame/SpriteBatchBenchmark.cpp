@@ -0,0 +1,193 @@
+#include "SpriteBatchBenchmark.h"
+
+#include <GameEngine/SpriteBatch.h>
+#include <glm/glm.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+const int SPRITE_COUNTS[] = { 20000, 100000, 1000000 };
+const int NUM_TEXTURES = 4; ///< Like the ball types of the game
+const int WARMUP_FRAMES = 3;
+const int TIMED_FRAMES = 20;
+const unsigned int SPRITE_SEED = 1337;
+const int SORT_TEXTURES = 16;
+const int SORT_RUNS = 10;
+
+struct BenchmarkSprite{
+	glm::vec4 destRect;
+	GLuint texture;
+	GameEngine::ColorRGBA8 color;
+};
+
+static std::vector<BenchmarkSprite> createSprites(int numSprites){
+	std::mt19937 randomEngine(SPRITE_SEED);
+	std::uniform_real_distribution<float> randX(0.0f, 1920.0f);
+	std::uniform_real_distribution<float> randY(0.0f, 1080.0f);
+	std::uniform_real_distribution<float> randRadius(2.0f, 6.0f);
+	std::uniform_int_distribution<int> randTexture(1, NUM_TEXTURES);
+	std::uniform_int_distribution<int> randColor(0, 255);
+
+	std::vector<BenchmarkSprite> sprites(numSprites);
+	for (auto& sprite : sprites)
+	{
+		float radius = randRadius(randomEngine);
+		sprite.destRect = glm::vec4(randX(randomEngine) - radius, randY(randomEngine) - radius, radius * 2.0f, radius * 2.0f);
+		sprite.texture = randTexture(randomEngine);
+		sprite.color = GameEngine::ColorRGBA8(randColor(randomEngine), randColor(randomEngine), randColor(randomEngine), 255);
+	}
+	return sprites;
+}
+
+void runSpriteBatchBenchmark(){
+	const glm::vec4 uvRect(0.0f, 0.0f, 1.0f, 1.0f);
+	std::vector<unsigned char> data;
+
+	for (int numSprites : SPRITE_COUNTS)
+	{
+		std::vector<BenchmarkSprite> sprites = createSprites(numSprites);
+
+		double verticesMs = 0.0;
+		size_t verticesBytes = 0;
+		for (GameEngine::SpriteBatchMode mode : { GameEngine::SpriteBatchMode::VERTICES, GameEngine::SpriteBatchMode::INSTANCED })
+		{
+			GameEngine::SpriteBatch spriteBatch;
+			spriteBatch.initHeadless(mode);
+
+			double frameMs = 0.0;
+			for (int frame = -WARMUP_FRAMES; frame < TIMED_FRAMES; frame++)
+			{
+				auto start = std::chrono::high_resolution_clock::now();
+
+				//Same calls as BallRenderer::renderBalls
+				spriteBatch.begin();
+				for (auto& sprite : sprites)
+				{
+					spriteBatch.draw(sprite.destRect, uvRect, sprite.texture, 0.0f, sprite.color);
+				}
+				spriteBatch.buildBatches(data);
+
+				auto end = std::chrono::high_resolution_clock::now();
+				if (frame >= 0)
+				{
+					frameMs += std::chrono::duration<double, std::milli>(end - start).count();
+				}
+			}
+			frameMs /= TIMED_FRAMES;
+
+			bool isInstanced = mode == GameEngine::SpriteBatchMode::INSTANCED;
+			if (!isInstanced)
+			{
+				verticesMs = frameMs;
+				verticesBytes = spriteBatch.getUploadedBytes();
+			}
+
+			printf("%8d sprites  %-9s  %8.3f ms/frame  %5.2fx  %9d KB/frame  %5.2fx  %d batches\n",
+				numSprites, isInstanced ? "instanced" : "vertices", frameMs, verticesMs / frameMs,
+				(int)(spriteBatch.getUploadedBytes() / 1024), (double)verticesBytes / spriteBatch.getUploadedBytes(),
+				(int)spriteBatch.getNumRenderBatches());
+		}
+	}
+}
+
+//The comparators SpriteBatch sorted its glypth pointers with before the radix sort
+static bool compareFrontToBack(const GameEngine::Glypth* a, const GameEngine::Glypth* b){
+	return a->depth < b->depth;
+}
+
+static bool compareBackToFront(const GameEngine::Glypth* a, const GameEngine::Glypth* b){
+	return a->depth > b->depth;
+}
+
+static bool compareTexture(const GameEngine::Glypth* a, const GameEngine::Glypth* b){
+	return a->texture < b->texture;
+}
+
+static bool compareDepthTexture(const GameEngine::Glypth* a, const GameEngine::Glypth* b){
+	return a->depth != b->depth ? a->depth < b->depth : a->texture < b->texture;
+}
+
+static const char* getSortTypeName(GameEngine::GlypthSortType sortType){
+	switch (sortType)
+	{
+	case GameEngine::GlypthSortType::FRONT_TO_BACK:
+		return "front to back";
+	case GameEngine::GlypthSortType::BACK_TO_FRONT:
+		return "back to front";
+	case GameEngine::GlypthSortType::TEXTURE:
+		return "texture";
+	default:
+		return "depth texture";
+	}
+}
+
+void runSpriteSortBenchmark(){
+	const glm::vec4 uvRect(0.0f, 0.0f, 1.0f, 1.0f);
+	const GameEngine::ColorRGBA8 color(255, 255, 255, 255);
+
+	for (int numSprites : SPRITE_COUNTS)
+	{
+		std::mt19937 randomEngine(SPRITE_SEED);
+		std::uniform_int_distribution<int> randTexture(1, SORT_TEXTURES);
+		std::uniform_int_distribution<int> randDepth(0, 99);
+
+		std::vector<GameEngine::Glypth> glypths;
+		glypths.reserve(numSprites);
+		for (int i = 0; i < numSprites; i++)
+		{
+			glypths.emplace_back(glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), uvRect, randTexture(randomEngine), (float)randDepth(randomEngine), color);
+		}
+
+		std::vector<GameEngine::Glypth*> glypthPointers(numSprites);
+		std::vector<GameEngine::GlypthSortKey> sortKeys(numSprites);
+		std::vector<GameEngine::GlypthSortKey> sortKeysTemp;
+
+		for (GameEngine::GlypthSortType sortType : { GameEngine::GlypthSortType::FRONT_TO_BACK, GameEngine::GlypthSortType::BACK_TO_FRONT,
+			GameEngine::GlypthSortType::TEXTURE, GameEngine::GlypthSortType::DEPTH_TEXTURE })
+		{
+			bool(*compare)(const GameEngine::Glypth*, const GameEngine::Glypth*) =
+				sortType == GameEngine::GlypthSortType::FRONT_TO_BACK ? compareFrontToBack :
+				sortType == GameEngine::GlypthSortType::BACK_TO_FRONT ? compareBackToFront :
+				sortType == GameEngine::GlypthSortType::TEXTURE ? compareTexture : compareDepthTexture;
+
+			//Both sides include building what they sort, like end() does
+			double stableSortMs = 0.0;
+			double radixSortMs = 0.0;
+			for (int run = 0; run < SORT_RUNS; run++)
+			{
+				auto start = std::chrono::high_resolution_clock::now();
+				for (int i = 0; i < numSprites; i++)
+				{
+					glypthPointers[i] = &glypths[i];
+				}
+				std::stable_sort(glypthPointers.begin(), glypthPointers.end(), compare);
+				auto middle = std::chrono::high_resolution_clock::now();
+				for (int i = 0; i < numSprites; i++)
+				{
+					sortKeys[i].key = GameEngine::SpriteBatch::makeSortKey(sortType, glypths[i].texture, glypths[i].depth);
+					sortKeys[i].index = i;
+				}
+				GameEngine::SpriteBatch::radixSort(sortKeys, sortKeysTemp);
+				auto end = std::chrono::high_resolution_clock::now();
+
+				stableSortMs += std::chrono::duration<double, std::milli>(middle - start).count();
+				radixSortMs += std::chrono::duration<double, std::milli>(end - middle).count();
+			}
+			stableSortMs /= SORT_RUNS;
+			radixSortMs /= SORT_RUNS;
+
+			//Both sorts are stable, so they agree on every position
+			bool sameOrder = true;
+			for (int i = 0; i < numSprites; i++)
+			{
+				sameOrder = sameOrder && glypthPointers[i] == &glypths[sortKeys[i].index];
+			}
+
+			printf("%8d sprites  %-13s  stable_sort %8.3f ms  radix sort %8.3f ms  %5.2fx  %s\n",
+				numSprites, getSortTypeName(sortType), stableSortMs, radixSortMs, stableSortMs / radixSortMs,
+				sameOrder ? "same order" : "ORDER DIFFERS");
+		}
+	}
+}
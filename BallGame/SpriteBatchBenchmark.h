@@ -0,0 +1,12 @@
+#pragma once
+
+/// Headless timing of SpriteBatch, started with "BallGame.exe --benchmark sprites".
+/// Draws 20k, 100k and 1M ball sprites per frame in SpriteBatchMode::VERTICES and SpriteBatchMode::INSTANCED
+/// and prints the batch build time (draw() calls, sort and writing the upload data) and the bytes a frame uploads.
+/// Runs without a window, the data is written into memory instead of a GL buffer
+void runSpriteBatchBenchmark();
+
+/// Times the radix sort of SpriteBatch against the std::stable_sort over glypth pointers it replaced,
+/// started with "BallGame.exe --benchmark sort". 20k, 100k and 1M sprites with random textures and depths
+/// for every sort type, and checks that both sorts give the same order
+void runSpriteSortBenchmark();
@@ -0,0 +1,266 @@
+#include "AssetPack.h"
+#include "Lz4.h"
+#include "TextureDiskCache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+
+namespace GameEngine{
+
+	const char PACK_MAGIC[4] = { 'G', 'E', 'P', 'K' };
+	const uint32_t PACK_VERSION = 1;
+
+	/// Start of every pack, the index follows right after it
+	struct PackHeader{
+		char magic[4];
+		uint32_t version;
+		uint64_t numEntries;
+		uint64_t pathsOffset;
+		uint64_t pathsSize;
+	};
+
+	static uint64_t hashPath(const std::string& normalizedPath){
+		return TextureDiskCache::hash((const unsigned char*)normalizedPath.data(), normalizedPath.size());
+	}
+
+	static uint64_t align(uint64_t offset){
+		return (offset + AssetPack::PACK_ALIGNMENT - 1) / AssetPack::PACK_ALIGNMENT * AssetPack::PACK_ALIGNMENT;
+	}
+
+	AssetPack::AssetPack()
+	{
+	}
+
+	AssetPack::~AssetPack()
+	{
+	}
+
+	bool AssetPack::open(const std::string& packPath){
+		close();
+
+		if (!m_file.open(packPath) || m_file.size() < sizeof(PackHeader))
+		{
+			close();
+			return false;
+		}
+
+		PackHeader header;
+		std::memcpy(&header, m_file.data(), sizeof(header));
+		uint64_t fileSize = m_file.size();
+		if (std::memcmp(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 || header.version != PACK_VERSION ||
+			header.numEntries > (fileSize - sizeof(PackHeader)) / sizeof(PackEntry) ||
+			header.pathsOffset != sizeof(PackHeader) + header.numEntries * sizeof(PackEntry) ||
+			header.pathsSize > fileSize - header.pathsOffset)
+		{
+			close();
+			return false;
+		}
+
+		//Checked once here, so lookups and reads can trust the index
+		const PackEntry* entries = (const PackEntry*)(m_file.data() + sizeof(PackHeader));
+		for (uint64_t i = 0; i < header.numEntries; i++)
+		{
+			const PackEntry& entry = entries[i];
+			if (entry.offset % PACK_ALIGNMENT != 0 || entry.offset > fileSize || entry.size > fileSize - entry.offset ||
+				(uint64_t)entry.pathOffset + entry.pathLength > header.pathsSize ||
+				(!(entry.flags & COMPRESSED) && entry.size != entry.originalSize) ||
+				(i > 0 && entries[i - 1].hash > entry.hash))
+			{
+				close();
+				return false;
+			}
+		}
+
+		m_entries = entries;
+		m_paths = m_file.chars() + header.pathsOffset;
+		m_numEntries = (size_t)header.numEntries;
+		m_path = packPath;
+		return true;
+	}
+
+	void AssetPack::close(){
+		m_file.close();
+		m_entries = nullptr;
+		m_paths = nullptr;
+		m_numEntries = 0;
+		m_path.clear();
+	}
+
+	const PackEntry* AssetPack::find(const std::string& filePath) const {
+		if (m_numEntries == 0)
+		{
+			return nullptr;
+		}
+
+		std::string path = normalizePath(filePath);
+		uint64_t hash = hashPath(path);
+
+		const PackEntry* end = m_entries + m_numEntries;
+		const PackEntry* entry = std::lower_bound(m_entries, end, hash, [](const PackEntry& other, uint64_t value){ return other.hash < value; });
+		for (; entry != end && entry->hash == hash; entry++)
+		{
+			if (entry->pathLength == path.size() && std::memcmp(m_paths + entry->pathOffset, path.data(), path.size()) == 0)
+			{
+				return entry;
+			}
+		}
+		return nullptr;
+	}
+
+	bool AssetPack::read(const PackEntry& entry, FileView& view) const {
+		view.close();
+
+		const unsigned char* data = m_file.data() + entry.offset;
+		if (entry.flags & COMPRESSED)
+		{
+			view.m_buffer.resize((size_t)entry.originalSize);
+			if (!Lz4::decompress(data, (size_t)entry.size, view.m_buffer.data(), view.m_buffer.size()))
+			{
+				view.close();
+				return false;
+			}
+			data = view.m_buffer.data();
+		}
+
+		view.m_data = data;
+		view.m_size = (size_t)entry.originalSize;
+		view.m_isOpen = true;
+		return true;
+	}
+
+	bool AssetPack::build(const std::string& packPath, const std::vector<std::string>& filePaths, bool compress, std::string& errorMessage){
+		struct PackedFile{
+			std::string path;
+			PackEntry entry;
+			std::vector<unsigned char> data;
+		};
+
+		std::vector<PackedFile> files(filePaths.size());
+		for (size_t i = 0; i < filePaths.size(); i++)
+		{
+			FileView view;
+			if (!view.open(filePaths[i]))
+			{
+				errorMessage = "Failed to open '" + filePaths[i] + "'";
+				return false;
+			}
+
+			PackedFile& file = files[i];
+			file.path = normalizePath(filePaths[i]);
+			file.entry = PackEntry();
+			file.entry.hash = hashPath(file.path);
+			file.entry.originalSize = view.size();
+			file.entry.contentHash = TextureDiskCache::hash(view.data(), view.size());
+
+			if (compress && view.size() > 0)
+			{
+				file.data.resize(Lz4::getMaxCompressedSize(view.size()));
+				file.data.resize(Lz4::compress(view.data(), view.size(), file.data.data()));
+				//Not worth a decompression on every load
+				if (file.data.size() <= view.size() - view.size() / 8)
+				{
+					file.entry.flags |= COMPRESSED;
+				}
+			}
+			if (!(file.entry.flags & COMPRESSED))
+			{
+				file.data.assign(view.data(), view.data() + view.size());
+			}
+			file.entry.size = file.data.size();
+		}
+
+		std::sort(files.begin(), files.end(), [](const PackedFile& a, const PackedFile& b){
+			return a.entry.hash != b.entry.hash ? a.entry.hash < b.entry.hash : a.path < b.path;
+		});
+
+		//Paths in index order, then the data
+		std::string paths;
+		for (size_t i = 0; i < files.size(); i++)
+		{
+			if (i > 0 && files[i].path == files[i - 1].path)
+			{
+				errorMessage = "'" + files[i].path + "' is in the pack twice";
+				return false;
+			}
+			files[i].entry.pathOffset = (uint32_t)paths.size();
+			files[i].entry.pathLength = (uint32_t)files[i].path.size();
+			paths += files[i].path;
+		}
+
+		PackHeader header = {};
+		std::memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+		header.version = PACK_VERSION;
+		header.numEntries = files.size();
+		header.pathsOffset = sizeof(PackHeader) + files.size() * sizeof(PackEntry);
+		header.pathsSize = paths.size();
+
+		uint64_t offset = header.pathsOffset + header.pathsSize;
+		for (auto& file : files)
+		{
+			offset = align(offset);
+			file.entry.offset = offset;
+			offset += file.entry.size;
+		}
+
+		//Written under another name first, like the texture cache, so a failed build never leaves half a pack behind
+		std::string tempPath = packPath + ".tmp";
+		FILE* out = fopen(tempPath.c_str(), "wb");
+		if (out == nullptr)
+		{
+			errorMessage = "Failed to create '" + tempPath + "'";
+			return false;
+		}
+
+		const unsigned char padding[PACK_ALIGNMENT] = {};
+		uint64_t written = 0;
+		auto write = [&](const void* data, size_t size){
+			if (size > 0 && fwrite(data, size, 1, out) != 1)
+			{
+				return false;
+			}
+			written += size;
+			return true;
+		};
+
+		bool ok = write(&header, sizeof(header));
+		for (auto& file : files)
+		{
+			ok = ok && write(&file.entry, sizeof(PackEntry));
+		}
+		ok = ok && write(paths.data(), paths.size());
+		for (auto& file : files)
+		{
+			ok = ok && write(padding, (size_t)(file.entry.offset - written)) && write(file.data.data(), file.data.size());
+		}
+		ok = fclose(out) == 0 && ok;
+
+		std::remove(packPath.c_str());
+		if (!ok || std::rename(tempPath.c_str(), packPath.c_str()) != 0)
+		{
+			std::remove(tempPath.c_str());
+			errorMessage = "Failed to write '" + packPath + "'";
+			return false;
+		}
+		return true;
+	}
+
+	std::string AssetPack::normalizePath(const std::string& filePath){
+		size_t start = 0;
+		while (filePath.compare(start, 2, "./") == 0 || filePath.compare(start, 2, ".\\") == 0)
+		{
+			start += 2;
+		}
+
+		std::string path;
+		path.reserve(filePath.size() - start);
+		for (size_t i = start; i < filePath.size(); i++)
+		{
+			char c = filePath[i];
+			path += c == '\\' ? '/' : (char)std::tolower((unsigned char)c);
+		}
+		return path;
+	}
+
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "IOManager.h"
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace GameEngine{
+
+	/// One file of the index, read straight out of the mapped pack
+	struct PackEntry{
+		uint64_t hash; ///< Of the normalized path, the index is sorted by it
+		uint64_t offset; ///< Of the data from the start of the pack, a multiple of PACK_ALIGNMENT
+		uint64_t size; ///< Of the stored data
+		uint64_t originalSize; ///< Same as size unless the entry is compressed
+		uint64_t contentHash; ///< TextureDiskCache::hash of the original data
+		uint32_t pathOffset; ///< Into the path block, the paths are not null terminated
+		uint32_t pathLength;
+		uint32_t flags;
+		uint32_t reserved;
+	};
+
+	/// Many asset files in one, opened with a single memory mapping. Layout: header, index (sorted by path
+	/// hash, so a lookup is a binary search), path block, then the data of every file, aligned to PACK_ALIGNMENT.
+	/// Files that got smaller by at least an eighth are stored LZ4 compressed, the others (PNG, MP3, OGG, ...)
+	/// are read from the mapping without a copy. Build packs with the AssetPacker tool, see IOManager::mountPack
+	class AssetPack
+	{
+	public:
+		static const uint32_t COMPRESSED = 1; ///< PackEntry::flags
+		static const size_t PACK_ALIGNMENT = 16;
+
+		AssetPack();
+		~AssetPack();
+
+		AssetPack(const AssetPack&) = delete;
+		AssetPack& operator=(const AssetPack&) = delete;
+
+		/// Maps the pack and checks that the index and every entry lie inside the file
+		bool open(const std::string& packPath);
+		void close();
+
+		bool isOpen() const { return m_file.isOpen(); }
+		const std::string& getPath() const { return m_path; }
+		size_t size() const { return m_numEntries; }
+
+		/// nullptr if the pack doesn't contain the file
+		const PackEntry* find(const std::string& filePath) const;
+
+		/// Points view into the mapping, or decompresses the entry into a buffer of the view
+		bool read(const PackEntry& entry, FileView& view) const;
+
+		/// Writes the files into a new pack, under their paths as given (relative to the directory the game runs in).
+		/// compress: try LZ4 on every file and keep it where it pays off
+		static bool build(const std::string& packPath, const std::vector<std::string>& filePaths, bool compress, std::string& errorMessage);
+
+		/// Lower case with / separators and without leading ./, like the file system on Windows sees paths
+		static std::string normalizePath(const std::string& filePath);
+
+	private:
+		FileView m_file;
+		const PackEntry* m_entries = nullptr;
+		const char* m_paths = nullptr;
+		size_t m_numEntries = 0;
+		std::string m_path;
+	};
+
+}
@@ -78,6 +78,7 @@ namespace GameEngine{
 
 			m_effectMap.clear();
 			m_musicMap.clear();
+			m_musicFiles.clear();
 
 			Mix_CloseAudio();
 			Mix_Quit();
@@ -92,7 +93,13 @@ namespace GameEngine{
 
 		if (it == m_effectMap.end())
 		{ // Failed to find it, must load
-			Mix_Chunk* chunk = Mix_LoadWAV(filePath.c_str());
+			FileView file;
+			if (!file.open(filePath)){
+				fatalError("Failed to open " + filePath);
+			}
+
+			//The whole effect is decoded here, the file isn't needed afterwards
+			Mix_Chunk* chunk = Mix_LoadWAV_RW(SDL_RWFromConstMem(file.data(), (int)file.size()), 1);
 			//check for errors (ex: invalid filePath)
 			if (chunk == nullptr){
 				fatalError("Mix_LoadWAV " + std::string(Mix_GetError()));
@@ -118,7 +125,12 @@ namespace GameEngine{
 
 		if (it == m_musicMap.end())
 		{ // Failed to find it, must load
-			Mix_Music* mixMusic = Mix_LoadMUS(filePath.c_str());
+			FileView file;
+			if (!file.open(filePath)){
+				fatalError("Failed to open " + filePath);
+			}
+
+			Mix_Music* mixMusic = Mix_LoadMUS_RW(SDL_RWFromConstMem(file.data(), (int)file.size()), 1);
 			//check for errors (ex: invalid filePath)
 			if (mixMusic == nullptr){
 				fatalError("Mix_LoadMUS " + std::string(Mix_GetError()));
@@ -126,6 +138,7 @@ namespace GameEngine{
 
 			music.m_music = mixMusic;
 			m_musicMap[filePath] = mixMusic;
+			m_musicFiles.emplace(filePath, std::move(file));
 
 		}
 		else{
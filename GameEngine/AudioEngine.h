@@ -4,6 +4,8 @@
 #include <string>
 #include <map>
 
+#include "IOManager.h"
+
 namespace GameEngine{
 
 	class SoundEffect
@@ -47,6 +49,7 @@ namespace GameEngine{
 		void init();
 		void destroy();
 
+		/// Both read the file through a FileView, so they find it in the mounted packs as well
 		SoundEffect loadSoundEffect(const std::string& filePath);
 
 		Music loadMusic(const std::string& filePath);
@@ -55,6 +58,7 @@ namespace GameEngine{
 
 		std::map<std::string, Mix_Chunk*> m_effectMap;
 		std::map<std::string, Mix_Music*> m_musicMap;
+		std::map<std::string, FileView> m_musicFiles; ///< Music is decoded while it plays, from these
 
 		bool m_isInitialized = false;
 		
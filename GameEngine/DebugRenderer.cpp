@@ -76,44 +76,18 @@ namespace GameEngine {
 
 		//Set up buffers
 		glGenVertexArrays(1, &m_vao);
-		glGenBuffers(1, &m_vbo);
-		glGenBuffers(1, &m_ibo);
+		m_vbo.init(GL_ARRAY_BUFFER);
+		m_ibo.init(GL_ELEMENT_ARRAY_BUFFER);
 
 		glBindVertexArray(m_vao);
-		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
 
-		//Vertex attrib pointers
+		//Vertex attrib pointers are set in render(), the stream buffer region changes every frame
 		glEnableVertexAttribArray(0);
-		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void *)offsetof(DebugVertex, position));
-
 		glEnableVertexAttribArray(1);
-		glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(DebugVertex), (void *)offsetof(DebugVertex, color));
 
 		glBindVertexArray(0);
 	}
 
-	void DebugRenderer::end(){
-		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-		//Orphan the buffer
-		glBufferData(GL_ARRAY_BUFFER, m_verts.size() * sizeof(DebugVertex), nullptr, GL_DYNAMIC_DRAW);
-		//Upload the Data
-		glBufferSubData(GL_ARRAY_BUFFER, 0, m_verts.size() * sizeof(DebugVertex), m_verts.data());
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo);
-		//Orphan the buffer
-		glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(GLuint), nullptr, GL_DYNAMIC_DRAW);
-		//Upload the Data
-		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, m_indices.size() * sizeof(GLuint), m_indices.data());
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-
-		m_numElements = m_indices.size();
-		m_indices.clear();
-		m_verts.clear();
-	}
-
-
 	glm::vec2 rotatePoint(glm::vec2 position, float angle){
 		glm::vec2 newVector;
 		newVector.x = position.x * cos(angle) - position.y * sin(angle);
@@ -122,75 +96,93 @@ namespace GameEngine {
 		return newVector;
 	}
 
-	void DebugRenderer::drawBox(glm::vec4& destRect, const ColorRGBA8& color, float angle){
-		int i = m_verts.size();
-		m_verts.resize(m_verts.size() + 4);
-
-
-		glm::vec2 halfDimensions(destRect.z / 2.0f, destRect.w / 2.0f);
-
-		//Get points centered at origin
-		glm::vec2 tl(-halfDimensions.x, halfDimensions.y);
-		glm::vec2 bl(-halfDimensions.x, -halfDimensions.y);
-
-		glm::vec2 br(halfDimensions.x, -halfDimensions.y);
-		glm::vec2 tr(halfDimensions.x, halfDimensions.y);
-
-		glm::vec2 positionOffset(destRect.x, destRect.y);
-
-		//Rotate the points
-		m_verts[i].position = rotatePoint(tl, angle) + halfDimensions + positionOffset;
-		m_verts[i + 1].position = rotatePoint(bl, angle) + halfDimensions + positionOffset;
-		m_verts[i + 2].position = rotatePoint(br, angle) + halfDimensions + positionOffset;
-		m_verts[i + 3].position = rotatePoint(tr, angle) + halfDimensions + positionOffset;
+	void DebugRenderer::end(){
+		const size_t numVerts = m_boxes.size() * 4 + m_circles.size() * NUM_CIRCLE_VERTS;
+		m_numElements = m_boxes.size() * 8 + m_circles.size() * NUM_CIRCLE_VERTS * 2;
 
-		for (int j = i; j < i + 4; j++)
+		if (m_numElements > 0)
 		{
-			m_verts[j].color = color;
+			DebugVertex* verts = (DebugVertex*)m_vbo.map(numVerts * sizeof(DebugVertex));
+			GLuint* indices = (GLuint*)m_ibo.map(m_numElements * sizeof(GLuint));
+
+			GLuint i = 0;
+
+			for (auto& box : m_boxes)
+			{
+				glm::vec2 halfDimensions(box.destRect.z / 2.0f, box.destRect.w / 2.0f);
+
+				//Get points centered at origin
+				glm::vec2 tl(-halfDimensions.x, halfDimensions.y);
+				glm::vec2 bl(-halfDimensions.x, -halfDimensions.y);
+
+				glm::vec2 br(halfDimensions.x, -halfDimensions.y);
+				glm::vec2 tr(halfDimensions.x, halfDimensions.y);
+
+				glm::vec2 positionOffset(box.destRect.x, box.destRect.y);
+
+				//Rotate the points
+				verts[i].position = rotatePoint(tl, box.angle) + halfDimensions + positionOffset;
+				verts[i + 1].position = rotatePoint(bl, box.angle) + halfDimensions + positionOffset;
+				verts[i + 2].position = rotatePoint(br, box.angle) + halfDimensions + positionOffset;
+				verts[i + 3].position = rotatePoint(tr, box.angle) + halfDimensions + positionOffset;
+
+				for (GLuint j = i; j < i + 4; j++)
+				{
+					verts[j].color = box.color;
+				}
+
+				*indices++ = i;
+				*indices++ = i + 1;
+
+				*indices++ = i + 1;
+				*indices++ = i + 2;
+
+				*indices++ = i + 2;
+				*indices++ = i + 3;
+
+				*indices++ = i + 3;
+				*indices++ = i;
+
+				i += 4;
+			}
+
+			for (auto& circle : m_circles)
+			{
+				//Set up vertices
+				for (int j = 0; j < NUM_CIRCLE_VERTS; j++)
+				{
+					float angle = ((float)j / NUM_CIRCLE_VERTS) * PI * 2.0f;
+					verts[i + j].position.x = (cos(angle) * circle.radius + circle.center.x);
+					verts[i + j].position.y = (sin(angle) * circle.radius + circle.center.y);
+					verts[i + j].color = circle.color;
+				}
+
+				//Set up indices for indexed drawing
+				for (int j = 0; j < NUM_CIRCLE_VERTS - 1; j++)
+				{
+					*indices++ = i + j;
+					*indices++ = i + j + 1;
+				}
+				*indices++ = i + NUM_CIRCLE_VERTS - 1;
+				*indices++ = i;
+
+				i += NUM_CIRCLE_VERTS;
+			}
+
+			m_vbo.unmap();
+			m_ibo.unmap();
 		}
 
-		m_indices.reserve(m_indices.size() + 8);
-
-		m_indices.push_back(i);
-		m_indices.push_back(i + 1);
-
-		m_indices.push_back(i + 1);
-		m_indices.push_back(i + 2);
-
-		m_indices.push_back(i + 2);
-		m_indices.push_back(i + 3);
+		m_boxes.clear();
+		m_circles.clear();
+	}
 
-		m_indices.push_back(i + 3);
-		m_indices.push_back(i);
+	void DebugRenderer::drawBox(glm::vec4& destRect, const ColorRGBA8& color, float angle){
+		m_boxes.push_back({ destRect, color, angle });
 	}
 
 	void DebugRenderer::drawCircle(const glm::vec2& center, const ColorRGBA8& color, float radius){
-
-		static const int NUM_VERTS = 100;
-		int start = m_verts.size();
-		m_verts.resize(m_verts.size() + NUM_VERTS);
-
-		//Set up vertices
-		for (size_t i = 0; i < NUM_VERTS; i++)
-		{
-			float angle = ((float)i / NUM_VERTS) * PI * 2.0f;
-			m_verts[start + i].position.x = (cos(angle) * radius + center.x);
-			m_verts[start + i].position.y = (sin(angle) * radius + center.y);
-			m_verts[start + i].color = color;
-		}
-
-		//Set up indices for indexed drawing
-		m_indices.reserve(m_indices.size() + NUM_VERTS * 2.0f);
-
-		for (size_t i = 0; i < NUM_VERTS - 1; i++)
-		{
-			m_indices.push_back(start + i);
-			m_indices.push_back(start + i + 1);
-		}
-		m_indices.push_back(start + NUM_VERTS - 1);
-		m_indices.push_back(start);
-
-
+		m_circles.push_back({ center, color, radius });
 	}
 
 
@@ -204,7 +196,18 @@ namespace GameEngine {
 
 		glBindVertexArray(m_vao);
 
-		glDrawElements(GL_LINES, m_numElements, GL_UNSIGNED_INT, 0);
+		if (m_numElements > 0)
+		{
+			const size_t base = m_vbo.getOffset();
+
+			glBindBuffer(GL_ARRAY_BUFFER, m_vbo.getID());
+			glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void *)(base + offsetof(DebugVertex, position)));
+			glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(DebugVertex), (void *)(base + offsetof(DebugVertex, color)));
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ibo.getID());
+			glDrawElements(GL_LINES, m_numElements, GL_UNSIGNED_INT, (void *)m_ibo.getOffset());
+		}
 
 		glBindVertexArray(0);
 
@@ -214,15 +217,11 @@ namespace GameEngine {
 	void DebugRenderer::dispose(){
 		if (m_vao){
 			glDeleteVertexArrays(1, &m_vao);
+			m_vao = 0;
 		}
 
-		if (m_vbo){
-			glDeleteBuffers(1, &m_vbo);
-		}
-
-		if (m_ibo){
-			glDeleteBuffers(1, &m_ibo);
-		}
+		m_vbo.dispose();
+		m_ibo.dispose();
 
 		m_program.dispose();
 	}
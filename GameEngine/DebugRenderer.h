@@ -4,6 +4,7 @@
 #include <vector>
 #include "Vertex.h"
 #include "GLSLProgram.h"
+#include "StreamBuffer.h"
 
 namespace GameEngine {
 
@@ -31,10 +32,26 @@ namespace GameEngine {
 		};
 
 	private:
+		//Shapes are only recorded here, end() writes their vertices straight into the stream buffers
+		struct DebugBox{
+			glm::vec4 destRect;
+			ColorRGBA8 color;
+			float angle;
+		};
+
+		struct DebugCircle{
+			glm::vec2 center;
+			ColorRGBA8 color;
+			float radius;
+		};
+
+		static const int NUM_CIRCLE_VERTS = 100;
+
 		GameEngine::GLSLProgram m_program;
-		std::vector<DebugVertex> m_verts;
-		std::vector<GLuint> m_indices;
-		GLuint m_vbo = 0, m_vao = 0, m_ibo = 0;
+		std::vector<DebugBox> m_boxes;
+		std::vector<DebugCircle> m_circles;
+		StreamBuffer m_vbo, m_ibo;
+		GLuint m_vao = 0;
 		int m_numElements = 0;
 	};
 
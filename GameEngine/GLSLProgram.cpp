@@ -18,7 +18,14 @@ namespace GameEngine{
 		}
 
 	void GLSLProgram::compileShadersFromSource(const char* vertexSource, const char* fragmentSource){
+		createShaders();
 
+		//-1 = zero terminated
+		compileShaders(vertexSource, -1, "Vertex Shader", m_vertexShaderID);
+		compileShaders(fragmentSource, -1, "Fragment Shader", m_fragmentShaderID);
+	}
+
+	void GLSLProgram::createShaders(){
 		//Get a program object.
 		m_programID = glCreateProgram();
 
@@ -31,22 +38,26 @@ namespace GameEngine{
 		if (m_fragmentShaderID == 0) {
 			fatalError("Fragment shader failed to be created!");
 		}
-
-		compileShaders(vertexSource, "Vertex Shader", m_vertexShaderID);
-		compileShaders(fragmentSource, "Fragment Shader", m_fragmentShaderID);
-
 	}
 
 
 	void GLSLProgram::compileShaders(const std::string& vertexShaderFilePath, const std::string& fragementShaderFilePath){
 
-		std::string vertSource;
-		std::string fragSource;
+		//The sources go to GL straight out of the mapped files, with their length instead of a terminating zero
+		FileView vertSource;
+		FileView fragSource;
+
+		if (!vertSource.open(vertexShaderFilePath)) {
+			fatalError("Failed to open " + vertexShaderFilePath);
+		}
+		if (!fragSource.open(fragementShaderFilePath)) {
+			fatalError("Failed to open " + fragementShaderFilePath);
+		}
 
-		IOManager::readFileToBuffer(vertexShaderFilePath, vertSource);
-		IOManager::readFileToBuffer(fragementShaderFilePath, fragSource);
+		createShaders();
 
-		compileShadersFromSource(vertSource.c_str(), fragSource.c_str());
+		compileShaders(vertSource.chars(), (GLint)vertSource.size(), "Vertex Shader", m_vertexShaderID);
+		compileShaders(fragSource.chars(), (GLint)fragSource.size(), "Fragment Shader", m_fragmentShaderID);
 		}
 
 	void GLSLProgram::linkShaders(){
@@ -131,9 +142,9 @@ namespace GameEngine{
 	}
 
 
-	void GLSLProgram::compileShaders(const char* source, const std::string& name, GLuint shaderID){
+	void GLSLProgram::compileShaders(const char* source, GLint length, const std::string& name, GLuint shaderID){
 
-		glShaderSource(shaderID, 1, &source, nullptr);
+		glShaderSource(shaderID, 1, &source, &length);
 
 		glCompileShader(shaderID);
 
@@ -31,7 +31,10 @@ namespace GameEngine{
 		private:
 			int m_numAttributes;
 
-			void compileShaders(const char* source, const std::string& name, GLuint shaderID);
+			/// Creates the program and the two shader objects
+			void createShaders();
+			/// length -1 = source ends with a zero
+			void compileShaders(const char* source, GLint length, const std::string& name, GLuint shaderID);
 
 			/*void compileShaders(const std::string& filePath, GLuint shaderID);*/
 
@@ -1,5 +1,6 @@
 #pragma once
 #include <GL/glew.h>
+#include <glm\glm.hpp>
 
 namespace GameEngine{
 
@@ -7,6 +8,12 @@ namespace GameEngine{
 		GLuint id;
 		int width;
 		int height;
+		glm::vec4 uvRect; ///< Part of the GL texture the image covers, (0, 0, 1, 1) unless it lives in a TextureAtlas
+
+		/// Maps uvs of the image to uvs of the GL texture
+		glm::vec4 mapUVs(const glm::vec4& uvs) const {
+			return glm::vec4(uvRect.x + uvs.x * uvRect.z, uvRect.y + uvs.y * uvRect.w, uvs.z * uvRect.z, uvs.w * uvRect.w);
+		}
 		};
 
-	}
\ No newline at end of file
+	}
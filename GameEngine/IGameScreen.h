@@ -6,6 +6,9 @@ namespace GameEngine {
 
 	class IMainGame;
 
+	/// The deltaTime of IGameScreen::update counts ticks of this rate, the rate the games were tuned at
+	const float BASE_TICK_RATE = 60.0f;
+
 	enum class ScreenState {
 		NONE,
 		RUNNING,
@@ -37,9 +40,11 @@ namespace GameEngine {
 		virtual void onEntry() = 0;
 		virtual void onExit() = 0;
 
-		//Called in the main game loop
-		virtual void update() = 0;
-		virtual void draw() = 0;
+		//Called in the main game loop, update once per fixed tick and draw once per frame.
+		//deltaTime is the length of a tick, 1.0 at BASE_TICK_RATE.
+		//alpha in [0, 1) is how far the time got from the last tick towards the next one, for interpolating
+		virtual void update(float deltaTime) = 0;
+		virtual void draw(float alpha) = 0;
 
 		int getScreenIndex() const {
 			return m_screenIndex;
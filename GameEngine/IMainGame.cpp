@@ -2,9 +2,15 @@
 #include "Timing.h"
 #include "ScreenList.h"
 #include "IGameScreen.h"
+#include "Profiler.h"
+#include "ResourceManager.h"
+
+#include <cmath>
 
 namespace GameEngine {
 
+	const float TEXTURE_UPLOAD_MILLISECONDS = 2.0f; ///< Per frame, for the textures loaded in the background
+
 	IMainGame::IMainGame()
 	{
 		m_screenList = std::make_unique<ScreenList>(this);
@@ -22,8 +28,15 @@ namespace GameEngine {
 			return;
 		}
 
+		Profiler::setThreadName("Main");
+
 		FpsLimiter limiter;
-		limiter.setMaxFPS(60.0f);
+		limiter.setMaxFPS(m_maxFPS);
+
+		const double counterFrequency = (double)SDL_GetPerformanceFrequency();
+		Uint64 previousCounter = SDL_GetPerformanceCounter();
+		//Time in seconds that hasn't been simulated yet
+		double accumulator = 0.0;
 
 		m_isRunning = true;
 
@@ -31,18 +44,53 @@ namespace GameEngine {
 		{
 			limiter.beginFrame();
 
-			inputManager.update();
+			Uint64 counter = SDL_GetPerformanceCounter();
+			accumulator += (counter - previousCounter) / counterFrequency;
+			previousCounter = counter;
+
+			//Run as many fixed ticks as fit into the elapsed time
+			const double tickTime = 1.0 / m_tickRate;
+			int ticks = 0;
+			while (accumulator >= tickTime && ticks < m_maxTicksPerFrame && m_isRunning)
+			{
+				inputManager.update();
+
+				//Call the custom update method
+				{
+					PROFILE_ZONE("IMainGame::update");
+					update(BASE_TICK_RATE / m_tickRate);
+				}
+
+				//F9 starts a profiler capture, the next F9 writes it out
+				if (inputManager.isKeyPressed(SDLK_F9))
+				{
+					Profiler::toggleCapture("profile.json");
+				}
 
-			//Call the custom update and draw method
-			update();
+				accumulator -= tickTime;
+				ticks++;
+			}
+
+			//Too far behind, drop the whole ticks but keep the fraction for the interpolation
+			if (accumulator >= tickTime)
+			{
+				accumulator = fmod(accumulator, tickTime);
+			}
 
 			if (m_isRunning)
 			{
-				draw();
+				ResourceManager::updateTextures(TEXTURE_UPLOAD_MILLISECONDS);
+
+				{
+					PROFILE_ZONE("IMainGame::draw");
+					draw((float)(accumulator / tickTime));
+				}
 
 				m_fps = limiter.end();
 				m_window.swapBuffer();
 			}
+
+			Profiler::endFrame();
 		}
 	}
 
@@ -82,12 +130,12 @@ namespace GameEngine {
 		}
 	}
 
-	void IMainGame::update(){
+	void IMainGame::update(float deltaTime){
 		if (m_currentScreen) // != nullptr
 		{
 			switch (m_currentScreen->getScreenState()) {
 			case ScreenState::RUNNING:
-				m_currentScreen->update();
+				m_currentScreen->update(deltaTime);
 				break;
 			case ScreenState::CHANGE_NEXT:
 				m_currentScreen->onExit();
@@ -124,12 +172,12 @@ namespace GameEngine {
 		}
 	}
 
-	void IMainGame::draw(){
+	void IMainGame::draw(float alpha){
 		glViewport(0, 0, m_window.getScreenWidth(), m_window.getScreenHeight());
 
 		if (m_currentScreen && m_currentScreen->getScreenState() == ScreenState::RUNNING)
 		{
-			m_currentScreen->draw();
+			m_currentScreen->draw(alpha);
 		}
 	}
 
@@ -29,14 +29,22 @@ namespace GameEngine{
 			return m_fps;
 		}
 
+		/// Ticks per second of the simulation, independent of the frame rate
+		void setTickRate(float tickRate) { m_tickRate = tickRate; }
+		/// A frame that is further behind skips the remaining ticks, so a slow machine runs the
+		/// game in slow motion instead of spending ever longer frames on catching up
+		void setMaxTicksPerFrame(int maxTicksPerFrame) { m_maxTicksPerFrame = maxTicksPerFrame; }
+		/// 0 = draw as often as possible
+		void setMaxFPS(float maxFPS) { m_maxFPS = maxFPS; }
+
 		
 
 		InputManager inputManager;
 		GameEngine::AudioEngine audioEngine;
 
 	protected:
-		virtual void update();
-		virtual void draw();
+		virtual void update(float deltaTime);
+		virtual void draw(float alpha);
 
 		bool init();
 		bool initSystems();
@@ -45,6 +53,9 @@ namespace GameEngine{
 		IGameScreen* m_currentScreen = nullptr;
 		bool m_isRunning = false;
 		float m_fps = 0.0f;
+		float m_tickRate = 60.0f;
+		int m_maxTicksPerFrame = 5;
+		float m_maxFPS = 60.0f;
 		Window m_window;
 	
 	};
@@ -1,56 +1,304 @@
 #include "IOManager.h"
+#include "AssetPack.h"
 
-#include <fstream>
+#include <utility>
+#include <algorithm>
+#include <cstring>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
 namespace GameEngine{
 
-	bool IOManager::readFileToBuffer(std::string filePath, std::vector<unsigned char>& buffer){
-		std::ifstream file(filePath, std::ios::binary);
-		if (file.fail()){
-			perror(filePath.c_str());
+	FileView::FileView()
+	{
+	}
+
+	FileView::~FileView()
+	{
+		close();
+	}
+
+	FileView::FileView(FileView&& other)
+	{
+		*this = std::move(other);
+	}
+
+	FileView& FileView::operator=(FileView&& other){
+		if (this != &other)
+		{
+			close();
+			std::swap(m_data, other.m_data);
+			std::swap(m_size, other.m_size);
+			std::swap(m_isOpen, other.m_isOpen);
+			std::swap(m_isMapped, other.m_isMapped);
+			m_buffer.swap(other.m_buffer);
+#ifdef _WIN32
+			std::swap(m_file, other.m_file);
+			std::swap(m_mapping, other.m_mapping);
+#endif
+		}
+		return *this;
+	}
+
+	bool FileView::open(const std::string& filePath){
+		close();
+
+		const AssetPack* pack;
+		const PackEntry* entry = IOManager::findPacked(filePath, &pack);
+		if (entry != nullptr)
+		{
+			return pack->read(*entry, *this);
+		}
+
+		return map(filePath);
+	}
+
+	bool FileView::map(const std::string& filePath){
+#ifdef _WIN32
+		HANDLE file = CreateFileA(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE)
+		{
 			return false;
 		}
+		m_file = file;
 
-		//seek to the end
-		file.seekg(0, std::ios::end);
+		LARGE_INTEGER size;
+		if (!GetFileSizeEx(file, &size))
+		{
+			close();
+			return false;
+		}
+		m_size = (size_t)size.QuadPart;
 
-		//Get the file size
-		int fileSize = file.tellg();
-		file.seekg(0, std::ios::beg);
+		//An empty file can't be mapped, but it is a valid empty view
+		if (m_size > 0)
+		{
+			m_mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+			if (m_mapping == nullptr)
+			{
+				close();
+				return false;
+			}
+			m_data = (const unsigned char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+			if (m_data == nullptr)
+			{
+				close();
+				return false;
+			}
+		}
+#else
+		int file = ::open(filePath.c_str(), O_RDONLY);
+		if (file < 0)
+		{
+			return false;
+		}
 
-		//Reduce the file size by any header bytes that might be present
-		fileSize -= file.tellg();
+		struct stat info;
+		if (fstat(file, &info) != 0)
+		{
+			::close(file);
+			return false;
+		}
+		m_size = (size_t)info.st_size;
 
-		buffer.resize(fileSize);
-		file.read((char *)&(buffer[0]), fileSize);
-		file.close();
+		//An empty file can't be mapped, but it is a valid empty view
+		if (m_size > 0)
+		{
+			void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, file, 0);
+			if (data == MAP_FAILED)
+			{
+				::close(file);
+				m_size = 0;
+				return false;
+			}
+			m_data = (const unsigned char*)data;
+		}
+		//The mapping stays valid without the descriptor
+		::close(file);
+#endif
 
+		m_isOpen = true;
+		m_isMapped = true;
 		return true;
+	}
 
+	void FileView::close(){
+#ifdef _WIN32
+		if (m_isMapped && m_data != nullptr) UnmapViewOfFile(m_data);
+		if (m_mapping != nullptr) CloseHandle(m_mapping);
+		if (m_file != nullptr) CloseHandle(m_file);
+		m_mapping = nullptr;
+		m_file = nullptr;
+#else
+		if (m_isMapped && m_data != nullptr) munmap((void*)m_data, m_size);
+#endif
+		std::vector<unsigned char>().swap(m_buffer);
+		m_data = nullptr;
+		m_size = 0;
+		m_isOpen = false;
+		m_isMapped = false;
 	}
 
-	bool IOManager::readFileToBuffer(std::string filePath, std::string& buffer) {
-		std::ifstream file(filePath, std::ios::binary);
-		if (file.fail()){
+	bool FileView::getLine(size_t& position, std::string& line) const {
+		if (position >= m_size)
+		{
+			return false;
+		}
+
+		const char* begin = chars() + position;
+		const char* end = chars() + m_size;
+		const char* lineEnd = begin;
+		while (lineEnd != end && *lineEnd != '\n')
+		{
+			lineEnd++;
+		}
+
+		position = (lineEnd - chars()) + (lineEnd != end ? 1 : 0);
+
+		if (lineEnd != begin && lineEnd[-1] == '\r')
+		{
+			lineEnd--;
+		}
+		line.assign(begin, lineEnd);
+		return true;
+	}
+
+	FileReader::FileReader()
+	{
+	}
+
+	FileReader::~FileReader()
+	{
+		close();
+	}
+
+	bool FileReader::open(const std::string& filePath){
+		close();
+
+		const AssetPack* pack;
+		const PackEntry* entry = IOManager::findPacked(filePath, &pack);
+		if (entry != nullptr)
+		{
+			if (!pack->read(*entry, m_packed))
+			{
+				return false;
+			}
+			m_size = m_packed.size();
+			return true;
+		}
+
+		m_file = fopen(filePath.c_str(), "rb");
+		if (m_file == nullptr)
+		{
+			return false;
+		}
+
+#ifdef _WIN32
+		_fseeki64(m_file, 0, SEEK_END);
+		m_size = _ftelli64(m_file);
+		_fseeki64(m_file, 0, SEEK_SET);
+#else
+		fseeko(m_file, 0, SEEK_END);
+		m_size = ftello(m_file);
+		fseeko(m_file, 0, SEEK_SET);
+#endif
+		return true;
+	}
+
+	void FileReader::close(){
+		if (m_file != nullptr)
+		{
+			fclose(m_file);
+			m_file = nullptr;
+		}
+		m_packed.close();
+		m_position = 0;
+		m_size = 0;
+	}
+
+	size_t FileReader::read(void* buffer, size_t size){
+		if (m_packed.isOpen())
+		{
+			size = std::min(size, m_packed.size() - m_position);
+			if (size > 0)
+			{
+				std::memcpy(buffer, m_packed.data() + m_position, size);
+			}
+			m_position += size;
+			return size;
+		}
+
+		if (m_file == nullptr)
+		{
+			return 0;
+		}
+		return fread(buffer, 1, size, m_file);
+	}
+
+	bool IOManager::readFileToBuffer(std::string filePath, std::vector<unsigned char>& buffer){
+		FileView file;
+		if (!file.open(filePath)){
 			perror(filePath.c_str());
 			return false;
 		}
 
-		//seek to the end
-		file.seekg(0, std::ios::end);
+		//One copy straight out of the mapping, no zero filling first
+		buffer.assign(file.data(), file.data() + file.size());
 
-		//Get the file size
-		int fileSize = file.tellg();
-		file.seekg(0, std::ios::beg);
+		return true;
 
-		//Reduce the file size by any header bytes that might be present
-		fileSize -= file.tellg();
+	}
+
+	bool IOManager::readFileToBuffer(std::string filePath, std::string& buffer) {
+		FileView file;
+		if (!file.open(filePath)){
+			perror(filePath.c_str());
+			return false;
+		}
 
-		buffer.resize(fileSize);
-		file.read((char *)&(buffer[0]), fileSize);
-		file.close();
+		buffer.assign(file.size() > 0 ? file.chars() : "", file.size());
 
 		return true;
 	}
 
-}
\ No newline at end of file
+	std::vector<std::unique_ptr<AssetPack>> IOManager::m_packs;
+
+	bool IOManager::mountPack(const std::string& packPath){
+		std::unique_ptr<AssetPack> pack(new AssetPack());
+		if (!pack->open(packPath))
+		{
+			return false;
+		}
+		m_packs.push_back(std::move(pack));
+		return true;
+	}
+
+	void IOManager::unmountPacks(){
+		m_packs.clear();
+	}
+
+	const PackEntry* IOManager::findPacked(const std::string& filePath, const AssetPack** pack /* = nullptr */){
+		for (auto it = m_packs.rbegin(); it != m_packs.rend(); ++it)
+		{
+			const PackEntry* entry = (*it)->find(filePath);
+			if (entry != nullptr)
+			{
+				if (pack != nullptr)
+				{
+					*pack = it->get();
+				}
+				return entry;
+			}
+		}
+		return nullptr;
+	}
+
+}
@@ -1,14 +1,101 @@
 #pragma once
 
 #include <vector>
+#include <string>
+#include <memory>
+#include <cstdio>
 
 namespace GameEngine{
 
+	class AssetPack;
+	struct PackEntry;
+
+	/// A whole file mapped read only into memory, no copy and no buffer of our own.
+	/// Unmaps the file when destroyed, so data() must not outlive the view.
+	/// A file in a mounted pack is a view into the pack, or a buffer if it had to be decompressed
+	class FileView
+		{
+		public:
+			friend class AssetPack;
+
+			FileView();
+			~FileView();
+
+			FileView(FileView&& other);
+			FileView& operator=(FileView&& other);
+			FileView(const FileView&) = delete;
+			FileView& operator=(const FileView&) = delete;
+
+			/// Looks into the mounted packs first, then on disk.
+			/// Fails quietly, the caller knows whether a missing file is an error
+			bool open(const std::string& filePath);
+			void close();
+
+			bool isOpen() const { return m_isOpen; }
+			const unsigned char* data() const { return m_data; }
+			const char* chars() const { return (const char*)m_data; }
+			size_t size() const { return m_size; }
+
+			/// Copies the line at position into line and moves position to the next one.
+			/// Accepts \n and \r\n, false at the end of the file
+			bool getLine(size_t& position, std::string& line) const;
+
+		private:
+			bool map(const std::string& filePath);
+
+			const unsigned char* m_data = nullptr;
+			size_t m_size = 0;
+			bool m_isOpen = false;
+			bool m_isMapped = false; ///< Else m_data belongs to a pack or m_buffer
+			std::vector<unsigned char> m_buffer; ///< A decompressed packed file
+#ifdef _WIN32
+			void* m_file = nullptr; ///< HANDLE
+			void* m_mapping = nullptr; ///< HANDLE
+#endif
+		};
+
+	/// Reads a file piece by piece through a small buffer, for files that are too big to hold at once.
+	/// A file in a mounted pack is read from the pack
+	class FileReader
+		{
+		public:
+			FileReader();
+			~FileReader();
+
+			FileReader(const FileReader&) = delete;
+			FileReader& operator=(const FileReader&) = delete;
+
+			bool open(const std::string& filePath);
+			void close();
+
+			/// Reads up to size bytes and returns how many it got, 0 at the end of the file
+			size_t read(void* buffer, size_t size);
+
+			unsigned long long getSize() const { return m_size; }
+
+		private:
+			FILE* m_file = nullptr;
+			FileView m_packed;
+			size_t m_position = 0; ///< In m_packed
+			unsigned long long m_size = 0;
+		};
+
 	class IOManager
 		{
 		public:
 			static bool readFileToBuffer(std::string filePath, std::vector<unsigned char>& buffer);
 			static bool readFileToBuffer(std::string filePath, std::string& buffer);
+
+			/// Every file of a mounted pack hides the loose file with the same path, a pack mounted later hides
+			/// the ones before it. Mount before loading anything, the texture loader threads look files up without a lock
+			static bool mountPack(const std::string& packPath);
+			static void unmountPacks();
+
+			/// The entry of the file in the mounted packs and its pack, nullptr for a loose (or missing) file
+			static const PackEntry* findPacked(const std::string& filePath, const AssetPack** pack = nullptr);
+
+		private:
+			static std::vector<std::unique_ptr<AssetPack>> m_packs;
 		};
 
-	}
\ No newline at end of file
+	}
@@ -2,49 +2,113 @@
 #include "picoPNG.h"
 #include "IOManager.h"
 #include "GameEngineErrors.h"
+#include "TextureDiskCache.h"
+
+#include <algorithm>
 
 namespace GameEngine{
 
 	GLTexture ImageLoader::loadPNG(std::string filePath){
-		GLTexture texture = {}; //initialze all values to zero
+		Image image;
+		std::string errorMessage;
+
+		if (readPNG(filePath, image, errorMessage) == false){
+			fatalError(errorMessage);
+			}
+
+		//Generate texture
+		GLuint textureID = 0;
+		glGenTextures(1, &textureID);
 
-		std::vector<unsigned char> in;
-		std::vector<unsigned char> out;
+		return uploadTexture(textureID, image);
+		}
+
+	bool ImageLoader::readPNG(const std::string& filePath, Image& image, std::string& errorMessage){
+		if (TextureDiskCache::load(filePath, image)){
+			return true;
+			}
 
-		unsigned long width, height;
+		//Decoded straight out of the mapped file
+		FileView in;
 
-		if (IOManager::readFileToBuffer(filePath, in) == false){
-			fatalError("Failed to load PNG file '" + filePath +"' to buffer!");
+		if (in.open(filePath) == false || in.size() == 0){
+			errorMessage = "Failed to load PNG file '" + filePath + "' to buffer!";
+			return false;
 			}
 
-		int errorCode = decodePNG(out, width, height, &(in[0]), in.size());
+		int errorCode = decodePNG(image.pixels, image.width, image.height, in.data(), in.size());
 		if (errorCode != 0){
-			fatalError("decodePNG failed with error: " + std::to_string(errorCode));
+			errorMessage = "decodePNG failed with error: " + std::to_string(errorCode);
+			return false;
 			}
+		image.data = image.pixels.data();
+		image.numLevels = 1;
 
-		//Generate texture
-		glGenTextures(1, &(texture.id)); 
+		//Also builds the mip levels, the next start only maps them
+		TextureDiskCache::store(filePath, in.data(), in.size(), image);
+
+		return true;
+		}
+
+	bool ImageLoader::readPNGSize(const std::string& filePath, int& width, int& height){
+		//8 bytes signature, then the IHDR chunk: length, type, width, height (big endian)
+		unsigned char header[24];
+		FileReader file;
+		if (!file.open(filePath) || file.read(header, sizeof(header)) != sizeof(header) || header[0] != 0x89 || header[1] != 'P' ||
+			header[12] != 'I' || header[13] != 'H' || header[14] != 'D' || header[15] != 'R'){
+			return false;
+			}
+
+		width = (header[16] << 24) | (header[17] << 16) | (header[18] << 8) | header[19];
+		height = (header[20] << 24) | (header[21] << 16) | (header[22] << 8) | header[23];
+		return true;
+		}
+
+	GLTexture ImageLoader::uploadTexture(GLuint textureID, const Image& image){
+		GLTexture texture = {}; //initialze all values to zero
+		texture.id = textureID;
 
 		//bind the texture
 		glBindTexture(GL_TEXTURE_2D, texture.id);
 
-		//upload the image data to the texture
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, &(out[0]));
+		//upload the image data to the texture, level by level if the mipmaps are already there
+		const unsigned char* level = image.data;
+		for (int i = 0; i < image.numLevels; i++){
+			GLsizei width = std::max(image.width >> i, 1ul);
+			GLsizei height = std::max(image.height >> i, 1ul);
+			glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, level);
+			level += (size_t)width * height * 4;
+			}
 
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.numLevels > 1 ? image.numLevels - 1 : 1000);
 
-		glGenerateMipmap(GL_TEXTURE_2D);
+		if (image.numLevels == 1){
+			glGenerateMipmap(GL_TEXTURE_2D);
+			}
 
 		//UNbind the texture
 		glBindTexture(GL_TEXTURE_2D, 0);
 
-		texture.width = width;
-		texture.height = height;
+		texture.width = image.width;
+		texture.height = image.height;
+		texture.uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
 
 		return texture;
 		}
 
-	}
\ No newline at end of file
+	void ImageLoader::uploadPlaceholder(GLuint textureID){
+		const unsigned char pixel[4] = { 255, 255, 255, 0 };
+
+		glBindTexture(GL_TEXTURE_2D, textureID);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+		//No mipmaps yet, so don't sample any
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		}
+
+	}
@@ -3,13 +3,38 @@
 #include "GLTexture.h"
 
 #include <string>
+#include <vector>
+#include <memory>
 
 namespace GameEngine{
 
+	/// Decoded RGBA pixels, 4 bytes per pixel
+	struct Image{
+		std::vector<unsigned char> pixels;
+		const unsigned char* data = nullptr; ///< All levels back to back, points into pixels or into storage
+		std::shared_ptr<void> storage; ///< Keeps data alive when it doesn't point into pixels, like a mapped cache file
+		unsigned long width = 0;
+		unsigned long height = 0;
+		int numLevels = 1; ///< 1 = only the full image, the mipmaps are generated on upload
+	};
+
 	class ImageLoader
 		{
 		public:
 			static GLTexture loadPNG(std::string filePath);
+
+			/// Reads and decodes the file without touching OpenGL, so it can run on any thread.
+			/// Takes the pixels from the TextureDiskCache when they are up to date and refreshes it otherwise
+			static bool readPNG(const std::string& filePath, Image& image, std::string& errorMessage);
+
+			/// Reads only the header of the PNG
+			static bool readPNGSize(const std::string& filePath, int& width, int& height);
+
+			/// Uploads the image into the texture and builds its mipmaps, needs the GL context
+			static GLTexture uploadTexture(GLuint textureID, const Image& image);
+
+			/// Fills the texture with a single transparent pixel, shown until the real image is uploaded
+			static void uploadPlaceholder(GLuint textureID);
 		};
 
-	}
\ No newline at end of file
+	}
@@ -0,0 +1,143 @@
+#include "JobSystem.h"
+#include "Profiler.h"
+
+#include <algorithm>
+
+namespace GameEngine{
+
+	const int RANGES_PER_THREAD = 4; ///< More ranges than threads, so a slow range doesn't hold up the others
+
+	JobSystem::JobSystem() : m_nextRange(0)
+	{
+	}
+
+
+	JobSystem::~JobSystem()
+	{
+		destroy();
+	}
+
+	void JobSystem::init(int numThreads){
+		destroy();
+
+		if (numThreads <= 0)
+		{
+			numThreads = std::max((int)std::thread::hardware_concurrency(), 1);
+		}
+
+		m_quit = false;
+		for (int i = 1; i < numThreads; i++)
+		{
+			m_workers.emplace_back(&JobSystem::workerLoop, this, i);
+		}
+	}
+
+	void JobSystem::destroy(){
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_wakeUp.notify_all();
+
+		for (auto& worker : m_workers)
+		{
+			worker.join();
+		}
+		m_workers.clear();
+	}
+
+	int JobSystem::getNumRanges(int count, int minRangeSize) const {
+		int maxRanges = count / std::max(minRangeSize, 1);
+		return std::max(std::min(getNumThreads() * RANGES_PER_THREAD, maxRanges), 1);
+	}
+
+	void JobSystem::parallelFor(int count, int minRangeSize, const RangeJob& job){
+		if (count <= 0)
+		{
+			return;
+		}
+
+		int numRanges = getNumRanges(count, minRangeSize);
+		if (numRanges == 1 || m_workers.empty())
+		{
+			//Not worth waking anybody up
+			for (int range = 0; range < numRanges; range++)
+			{
+				job((int)((long long)count * range / numRanges), (int)((long long)count * (range + 1) / numRanges), range);
+			}
+			return;
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_job = &job;
+			m_count = count;
+			m_numRanges = numRanges;
+			m_nextRange = 0;
+			m_rangesDone = 0;
+			m_generation++;
+		}
+		m_wakeUp.notify_all();
+
+		runRanges();
+
+		//Also wait for the workers to leave runRanges, so none of them grabs a range of the next loop
+		std::unique_lock<std::mutex> lock(m_mutex);
+		m_done.wait(lock, [this]{ return m_rangesDone == m_numRanges && m_busyWorkers == 0; });
+		m_job = nullptr;
+	}
+
+	void JobSystem::workerLoop(int worker){
+		Profiler::setThreadName("Worker " + std::to_string(worker));
+
+		unsigned int generation = 0;
+
+		while (true)
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wakeUp.wait(lock, [&]{ return m_quit || (m_job != nullptr && m_generation != generation); });
+				if (m_quit)
+				{
+					return;
+				}
+				generation = m_generation;
+				m_busyWorkers++;
+			}
+
+			runRanges();
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_busyWorkers--;
+			}
+			m_done.notify_all();
+		}
+	}
+
+	void JobSystem::runRanges(){
+		int finished = 0;
+
+		while (true)
+		{
+			int range = m_nextRange++;
+			if (range >= m_numRanges)
+			{
+				break;
+			}
+
+			int begin = (int)((long long)m_count * range / m_numRanges);
+			int end = (int)((long long)m_count * (range + 1) / m_numRanges);
+			(*m_job)(begin, end, range);
+			finished++;
+		}
+
+		if (finished > 0)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_rangesDone += finished;
+		}
+		m_done.notify_all();
+	}
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+namespace GameEngine{
+
+	/// A few worker threads that split loops into index ranges.
+	/// parallelFor blocks until every range is done, the calling thread works on ranges as well.
+	/// The ranges only depend on the count and the number of threads, and every range gets its index,
+	/// so results gathered per range can be merged in a fixed order afterwards
+	class JobSystem
+	{
+	public:
+		/// job(begin, end, range) handles the indices [begin, end)
+		typedef std::function<void(int, int, int)> RangeJob;
+
+		JobSystem();
+		~JobSystem();
+
+		/// numThreads counts the calling thread, 0 = one per core, 1 = everything runs on the calling thread
+		void init(int numThreads = 0);
+
+		/// Stops and joins the workers
+		void destroy();
+
+		int getNumThreads() const { return m_workers.size() + 1; }
+
+		/// Number of ranges parallelFor splits count indices into, every range has at least minRangeSize indices
+		int getNumRanges(int count, int minRangeSize) const;
+
+		void parallelFor(int count, int minRangeSize, const RangeJob& job);
+
+	private:
+		void workerLoop(int worker);
+		/// Takes ranges of the current loop until none are left
+		void runRanges();
+
+		std::vector<std::thread> m_workers;
+
+		std::mutex m_mutex;
+		std::condition_variable m_wakeUp; ///< Workers wait for a new loop or for quitting
+		std::condition_variable m_done; ///< parallelFor waits for the last range
+
+		//The current loop, only written while no worker is busy
+		const RangeJob* m_job = nullptr;
+		int m_count = 0;
+		int m_numRanges = 0;
+		std::atomic<int> m_nextRange;
+		int m_rangesDone = 0;
+		int m_busyWorkers = 0;
+		unsigned int m_generation = 0; ///< Counts the loops, so a worker knows when there is a new one
+		bool m_quit = false;
+	};
+
+}
@@ -0,0 +1,201 @@
+#include "Lz4.h"
+
+#include <cstring>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <algorithm>
+
+namespace GameEngine{
+
+	const size_t MIN_MATCH = 4;
+	const size_t MAX_OFFSET = 65535;
+	const size_t LAST_LITERALS = 5; ///< A block always ends with at least this many literals
+	const size_t MATCH_FIND_LIMIT = 12; ///< The last match starts at least this far before the end
+	const int HASH_BITS = 14;
+	const size_t NO_POSITION = (size_t)-1;
+	const size_t FAST_COPY = 16; ///< Short copies far from the end of the buffers copy this much, more than they need
+
+	static uint32_t read32(const unsigned char* data){
+		uint32_t value;
+		std::memcpy(&value, data, sizeof(value));
+		return value;
+	}
+
+	static uint32_t hashSequence(uint32_t sequence){
+		return (sequence * 2654435761u) >> (32 - HASH_BITS);
+	}
+
+	/// 15 fits into the token, the rest follows as a run of 255s and the remainder
+	static unsigned char* writeLength(unsigned char* out, size_t length){
+		length -= 15;
+		while (length >= 255)
+		{
+			*out++ = 255;
+			length -= 255;
+		}
+		*out++ = (unsigned char)length;
+		return out;
+	}
+
+	static bool readLength(const unsigned char*& in, const unsigned char* inEnd, size_t& length){
+		unsigned char byte;
+		do
+		{
+			if (in == inEnd)
+			{
+				return false;
+			}
+			byte = *in++;
+			length += byte;
+		} while (byte == 255);
+		return true;
+	}
+
+	static unsigned char* writeLiterals(unsigned char* out, unsigned char* token, const unsigned char* literals, size_t length){
+		*token = (unsigned char)((length < 15 ? length : 15) << 4);
+		if (length >= 15)
+		{
+			out = writeLength(out, length);
+		}
+		std::memcpy(out, literals, length);
+		return out + length;
+	}
+
+	size_t Lz4::compress(const unsigned char* source, size_t size, unsigned char* destination){
+		unsigned char* out = destination;
+		size_t anchor = 0; ///< Start of the literals not written yet
+
+		if (size > MATCH_FIND_LIMIT)
+		{
+			std::vector<size_t> table(1 << HASH_BITS, NO_POSITION); ///< Last position of every hashed 4 byte sequence
+			size_t matchEnd = size - LAST_LITERALS;
+
+			size_t position = 0;
+			while (position + MATCH_FIND_LIMIT <= size)
+			{
+				uint32_t sequence = read32(source + position);
+				size_t& slot = table[hashSequence(sequence)];
+				size_t candidate = slot;
+				slot = position;
+
+				if (candidate == NO_POSITION || position - candidate > MAX_OFFSET || read32(source + candidate) != sequence)
+				{
+					position++;
+					continue;
+				}
+
+				size_t length = MIN_MATCH;
+				while (position + length < matchEnd && source[candidate + length] == source[position + length])
+				{
+					length++;
+				}
+
+				unsigned char* token = out++;
+				out = writeLiterals(out, token, source + anchor, position - anchor);
+
+				size_t offset = position - candidate;
+				*out++ = (unsigned char)offset;
+				*out++ = (unsigned char)(offset >> 8);
+
+				size_t matchLength = length - MIN_MATCH;
+				*token |= (unsigned char)(matchLength < 15 ? matchLength : 15);
+				if (matchLength >= 15)
+				{
+					out = writeLength(out, matchLength);
+				}
+
+				position += length;
+				anchor = position;
+			}
+		}
+
+		//The last sequence has no match
+		unsigned char* token = out++;
+		out = writeLiterals(out, token, source + anchor, size - anchor);
+
+		return out - destination;
+	}
+
+	bool Lz4::decompress(const unsigned char* source, size_t sourceSize, unsigned char* destination, size_t size){
+		const unsigned char* in = source;
+		const unsigned char* inEnd = source + sourceSize;
+		unsigned char* out = destination;
+		unsigned char* outEnd = destination + size;
+
+		while (in != inEnd)
+		{
+			unsigned char token = *in++;
+
+			size_t literals = token >> 4;
+			if (literals == 15 && !readLength(in, inEnd, literals))
+			{
+				return false;
+			}
+			if (literals > (size_t)(inEnd - in) || literals > (size_t)(outEnd - out))
+			{
+				return false;
+			}
+			//Most sequences are short, a fixed size copy beats a call with a variable size. The extra bytes get overwritten later
+			if (literals <= FAST_COPY && inEnd - in >= (ptrdiff_t)FAST_COPY && outEnd - out >= (ptrdiff_t)FAST_COPY)
+			{
+				std::memcpy(out, in, FAST_COPY);
+			}
+			else
+			{
+				std::memcpy(out, in, literals);
+			}
+			in += literals;
+			out += literals;
+
+			if (in == inEnd)
+			{
+				break;
+			}
+
+			if (inEnd - in < 2)
+			{
+				return false;
+			}
+			size_t offset = in[0] | (in[1] << 8);
+			in += 2;
+			if (offset == 0 || offset > (size_t)(out - destination))
+			{
+				return false;
+			}
+
+			size_t length = token & 15;
+			if (length == 15 && !readLength(in, inEnd, length))
+			{
+				return false;
+			}
+			length += MIN_MATCH;
+			if (length > (size_t)(outEnd - out))
+			{
+				return false;
+			}
+
+			//A match may overlap the bytes it produces (offset 1 repeats one byte). The copied part repeats with
+			//the offset, so every copy can take twice as much as the one before without overlapping
+			const unsigned char* match = out - offset;
+			unsigned char* matchEnd = out + length;
+			if (offset >= FAST_COPY && outEnd - matchEnd >= (ptrdiff_t)FAST_COPY)
+			{
+				for (; out < matchEnd; out += FAST_COPY, match += FAST_COPY)
+				{
+					std::memcpy(out, match, FAST_COPY);
+				}
+				out = matchEnd;
+			}
+			while (out != matchEnd)
+			{
+				size_t chunk = std::min((size_t)(out - match), (size_t)(matchEnd - out));
+				std::memcpy(out, match, chunk);
+				out += chunk;
+			}
+		}
+
+		return out == outEnd;
+	}
+
+}
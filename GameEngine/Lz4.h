@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+
+namespace GameEngine{
+
+	/// The LZ4 block format (no frame around it), so the output can be read by any LZ4 decoder and the other way round.
+	/// Greedy matching with a small hash table: compresses worse than the reference encoder, but decompressing
+	/// is the same few copies per sequence
+	class Lz4
+	{
+	public:
+		/// Worst case size of compress for size bytes, incompressible data grows a little
+		static size_t getMaxCompressedSize(size_t size) { return size + size / 255 + 16; }
+
+		/// Compresses size bytes into destination (getMaxCompressedSize(size) bytes) and returns the compressed size
+		static size_t compress(const unsigned char* source, size_t size, unsigned char* destination);
+
+		/// Fails on corrupt data and if source doesn't decompress to exactly size bytes, never writes past destination + size
+		static bool decompress(const unsigned char* source, size_t sourceSize, unsigned char* destination, size_t size);
+	};
+
+}
@@ -0,0 +1,256 @@
+#include "Profiler.h"
+
+#include <chrono>
+#include <mutex>
+#include <memory>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace GameEngine{
+
+	const uint64_t EVENTS_PER_THREAD = 16384; ///< Ring buffer size, a power of two
+
+	/// The zones of one thread. Only the owning thread moves m_head and only endFrame moves m_tail
+	struct ThreadBuffer{
+		ThreadBuffer(int thread) : events(EVENTS_PER_THREAD), head(0), tail(0), thread(thread) {}
+
+		std::vector<ProfileEvent> events;
+		std::atomic<uint64_t> head;
+		std::atomic<uint64_t> tail;
+		std::atomic<uint64_t> dropped{ 0 }; ///< Zones that didn't fit because nobody called endFrame
+		int thread;
+		std::string name; ///< Guarded by s_threadsMutex
+	};
+
+	//The buffers are never freed, so endFrame can still drain the ones of finished threads
+	static std::mutex s_threadsMutex;
+	static std::vector<std::unique_ptr<ThreadBuffer>> s_threads;
+
+	static thread_local ThreadBuffer* t_buffer = nullptr;
+	static thread_local ProfileZone* t_currentZone = nullptr;
+
+	static const std::chrono::steady_clock::time_point s_startTime = std::chrono::steady_clock::now();
+
+	std::atomic<bool> Profiler::m_enabled(false);
+	bool Profiler::m_capturing = false;
+	std::vector<ProfileEvent> Profiler::m_captured;
+	std::vector<ProfileZoneStats> Profiler::m_frameSummary;
+	uint64_t Profiler::m_frameStart = 0;
+	float Profiler::m_frameTime = 0.0f;
+	uint64_t Profiler::m_droppedEvents = 0;
+
+	static ThreadBuffer* getThreadBuffer(){
+		if (t_buffer == nullptr)
+		{
+			std::lock_guard<std::mutex> lock(s_threadsMutex);
+			s_threads.push_back(std::make_unique<ThreadBuffer>((int)s_threads.size()));
+			t_buffer = s_threads.back().get();
+		}
+		return t_buffer;
+	}
+
+	static void appendJsonString(std::string& out, const char* text){
+		out += '"';
+		for (const char* c = text; *c != '\0'; c++)
+		{
+			if (*c == '"' || *c == '\\')
+			{
+				out += '\\';
+			}
+			out += *c;
+		}
+		out += '"';
+	}
+
+	void Profiler::setEnabled(bool enabled){
+		m_enabled.store(enabled, std::memory_order_relaxed);
+	}
+
+	void Profiler::setThreadName(const std::string& name){
+		ThreadBuffer* buffer = getThreadBuffer();
+
+		std::lock_guard<std::mutex> lock(s_threadsMutex);
+		buffer->name = name;
+	}
+
+	void Profiler::endFrame(){
+		uint64_t frameEnd = now();
+		m_frameTime = m_frameStart == 0 ? 0.0f : (frameEnd - m_frameStart) * 1e-6f;
+
+		m_frameSummary.clear();
+
+		{
+			std::lock_guard<std::mutex> lock(s_threadsMutex);
+			for (auto& buffer : s_threads)
+			{
+				uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+				uint64_t head = buffer->head.load(std::memory_order_acquire);
+				for (; tail != head; tail++)
+				{
+					const ProfileEvent& event = buffer->events[tail & (EVENTS_PER_THREAD - 1)];
+					summarize(event);
+					if (m_capturing)
+					{
+						m_captured.push_back(event);
+					}
+				}
+				buffer->tail.store(tail, std::memory_order_release);
+				m_droppedEvents += buffer->dropped.exchange(0, std::memory_order_relaxed);
+			}
+		}
+
+		std::sort(m_frameSummary.begin(), m_frameSummary.end(), [](const ProfileZoneStats& a, const ProfileZoneStats& b){
+			return a.depth != b.depth ? a.depth < b.depth : a.totalMs > b.totalMs;
+		});
+
+		//The frame itself shows up as the outermost zone of the trace
+		if (m_capturing && m_frameStart != 0)
+		{
+			ProfileEvent frame = { "Frame", m_frameStart, frameEnd - m_frameStart, 0, -1, getThreadBuffer()->thread };
+			m_captured.push_back(frame);
+		}
+		m_frameStart = frameEnd;
+	}
+
+	void Profiler::printFrameSummary(){
+		std::printf("Frame %.3f ms\n", m_frameTime);
+		for (auto& stats : m_frameSummary)
+		{
+			std::printf("%*s%-32s %5d calls %9.3f ms total %9.3f ms self\n", stats.depth * 2, "", stats.name, stats.calls, stats.totalMs, stats.selfMs);
+		}
+		if (m_droppedEvents > 0)
+		{
+			std::printf("%llu zones dropped, endFrame isn't called often enough\n", (unsigned long long)m_droppedEvents);
+		}
+	}
+
+	void Profiler::beginCapture(){
+		m_captured.clear();
+		m_capturing = true;
+		setEnabled(true);
+	}
+
+	bool Profiler::endCapture(const std::string& filePath){
+		m_capturing = false;
+
+		std::string json = "{\"traceEvents\":[\n";
+		char buffer[128];
+		{
+			std::lock_guard<std::mutex> lock(s_threadsMutex);
+			for (auto& thread : s_threads)
+			{
+				std::snprintf(buffer, sizeof(buffer), "{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":", thread->thread);
+				json += buffer;
+				appendJsonString(json, thread->name.empty() ? "Thread" : thread->name.c_str());
+				json += "}},\n";
+			}
+		}
+
+		for (size_t i = 0; i < m_captured.size(); i++)
+		{
+			const ProfileEvent& event = m_captured[i];
+			json += "{\"name\":";
+			appendJsonString(json, event.name);
+			//Chrome wants microseconds
+			std::snprintf(buffer, sizeof(buffer), ",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}", event.thread, event.start * 1e-3, event.duration * 1e-3);
+			json += buffer;
+			json += i + 1 < m_captured.size() ? ",\n" : "\n";
+		}
+		json += "]}\n";
+
+		m_captured.clear();
+		m_captured.shrink_to_fit();
+
+		std::ofstream file(filePath, std::ios::binary);
+		if (file.fail())
+		{
+			perror(filePath.c_str());
+			return false;
+		}
+		file.write(json.data(), json.size());
+
+		return !file.fail();
+	}
+
+	void Profiler::toggleCapture(const std::string& filePath){
+		if (m_capturing)
+		{
+			printFrameSummary();
+			if (endCapture(filePath))
+			{
+				std::cout << "Profile written to " << filePath << std::endl;
+			}
+			setEnabled(false);
+		}
+		else
+		{
+			beginCapture();
+		}
+	}
+
+	uint64_t Profiler::now(){
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - s_startTime).count();
+	}
+
+	void Profiler::record(const ProfileEvent& event){
+		ThreadBuffer* buffer = getThreadBuffer();
+
+		uint64_t head = buffer->head.load(std::memory_order_relaxed);
+		if (head - buffer->tail.load(std::memory_order_acquire) >= EVENTS_PER_THREAD)
+		{
+			buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+
+		ProfileEvent& slot = buffer->events[head & (EVENTS_PER_THREAD - 1)];
+		slot = event;
+		slot.thread = buffer->thread;
+		buffer->head.store(head + 1, std::memory_order_release);
+	}
+
+	void Profiler::summarize(const ProfileEvent& event){
+		ProfileZoneStats* stats = nullptr;
+		for (auto& it : m_frameSummary)
+		{
+			if (it.name == event.name || std::strcmp(it.name, event.name) == 0)
+			{
+				stats = &it;
+				break;
+			}
+		}
+		if (stats == nullptr)
+		{
+			m_frameSummary.push_back({ event.name, 0, 0.0f, 0.0f, event.depth });
+			stats = &m_frameSummary.back();
+		}
+
+		stats->calls++;
+		stats->totalMs += event.duration * 1e-6f;
+		stats->selfMs += event.selfDuration * 1e-6f;
+		stats->depth = std::min(stats->depth, event.depth);
+	}
+
+	void ProfileZone::begin(){
+		m_parent = t_currentZone;
+		m_depth = m_parent != nullptr ? m_parent->m_depth + 1 : 0;
+		t_currentZone = this;
+		m_start = Profiler::now();
+	}
+
+	void ProfileZone::end(){
+		uint64_t duration = Profiler::now() - m_start;
+
+		t_currentZone = m_parent;
+		if (m_parent != nullptr)
+		{
+			m_parent->m_childDuration += duration;
+		}
+
+		ProfileEvent event = { m_name, m_start, duration, duration - std::min(m_childDuration, duration), m_depth, 0 };
+		Profiler::record(event);
+	}
+
+}
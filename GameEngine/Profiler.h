@@ -0,0 +1,121 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <atomic>
+
+//0 compiles every zone out, with 1 a zone of a disabled profiler costs one flag check
+#ifndef GAMEENGINE_PROFILE
+#define GAMEENGINE_PROFILE 1
+#endif
+
+namespace GameEngine{
+
+	/// One finished zone
+	struct ProfileEvent{
+		const char* name; ///< Must outlive the profiler, string literals do
+		uint64_t start; ///< Nanoseconds since the program started
+		uint64_t duration;
+		uint64_t selfDuration; ///< duration without the zones nested into it
+		int depth; ///< Number of zones around it on its thread
+		int thread;
+	};
+
+	/// All zones of one name in one frame, summed over all threads
+	struct ProfileZoneStats{
+		const char* name;
+		int calls;
+		float totalMs;
+		float selfMs;
+		int depth; ///< Smallest depth the zone was seen at
+	};
+
+	/// Collects the zones of all threads.
+	/// Every thread writes its zones into a ring buffer of its own without taking a lock,
+	/// endFrame drains all of them on the main thread into the frame summary and the capture
+	class Profiler
+	{
+	public:
+		static void setEnabled(bool enabled);
+		static bool isEnabled() { return m_enabled.load(std::memory_order_relaxed); }
+
+		/// Name of the calling thread in the trace
+		static void setThreadName(const std::string& name);
+
+		/// Collects the zones of all threads, call it once per frame on the main thread
+		static void endFrame();
+
+		/// Zones of the last frame, sorted by depth and then by total time
+		static const std::vector<ProfileZoneStats>& getFrameSummary() { return m_frameSummary; }
+		/// Time between the last two endFrame calls in milliseconds
+		static float getFrameTime() { return m_frameTime; }
+		static void printFrameSummary();
+
+		/// Keeps every zone from now on until endCapture writes them out. Enables the profiler
+		static void beginCapture();
+		/// Writes the captured zones as Chrome trace JSON (chrome://tracing or ui.perfetto.dev)
+		static bool endCapture(const std::string& filePath);
+		static bool isCapturing() { return m_capturing; }
+		/// Starts a capture, or prints the last frame, writes the capture and disables the profiler again
+		static void toggleCapture(const std::string& filePath);
+
+		/// Nanoseconds since the program started
+		static uint64_t now();
+
+		/// Called by ProfileZone
+		static void record(const ProfileEvent& event);
+
+	private:
+		static void summarize(const ProfileEvent& event);
+
+		static std::atomic<bool> m_enabled;
+		static bool m_capturing;
+		static std::vector<ProfileEvent> m_captured;
+		static std::vector<ProfileZoneStats> m_frameSummary;
+		static uint64_t m_frameStart;
+		static float m_frameTime;
+		static uint64_t m_droppedEvents;
+	};
+
+	/// Measures the scope it lives in, use the PROFILE_ZONE macro
+	class ProfileZone
+	{
+	public:
+		explicit ProfileZone(const char* name) : m_name(name), m_active(Profiler::isEnabled()) {
+			if (m_active)
+			{
+				begin();
+			}
+		}
+		~ProfileZone() {
+			if (m_active)
+			{
+				end();
+			}
+		}
+
+		ProfileZone(const ProfileZone&) = delete;
+		ProfileZone& operator=(const ProfileZone&) = delete;
+
+	private:
+		void begin();
+		void end();
+
+		const char* m_name;
+		bool m_active;
+		int m_depth = 0;
+		uint64_t m_start = 0;
+		uint64_t m_childDuration = 0; ///< Added up by the zones nested into this one
+		ProfileZone* m_parent = nullptr;
+	};
+
+}
+
+#if GAMEENGINE_PROFILE
+#define GAMEENGINE_PROFILE_CONCAT2(a, b) a##b
+#define GAMEENGINE_PROFILE_CONCAT(a, b) GAMEENGINE_PROFILE_CONCAT2(a, b)
+#define PROFILE_ZONE(name) GameEngine::ProfileZone GAMEENGINE_PROFILE_CONCAT(profileZone, __LINE__)(name)
+#else
+#define PROFILE_ZONE(name)
+#endif
@@ -8,4 +8,24 @@ namespace GameEngine{
 		return m_textureCache.getTexture(texturePath);
 		}
 
+	GLTexture ResourceManager::getTextureAsync(const std::string& texturePath){
+		return m_textureCache.getTextureAsync(texturePath);
+		}
+
+	GLTexture ResourceManager::getAtlasTexture(const std::string& texturePath){
+		return m_textureCache.getAtlasTexture(texturePath);
+		}
+
+	GLTexture ResourceManager::getAtlasTextureAsync(const std::string& texturePath){
+		return m_textureCache.getAtlasTextureAsync(texturePath);
+		}
+
+	void ResourceManager::updateTextures(float maxMilliseconds){
+		m_textureCache.processUploads(maxMilliseconds);
+		}
+
+	bool ResourceManager::isLoadingTextures(){
+		return m_textureCache.isLoading();
+		}
+
 	}
\ No newline at end of file
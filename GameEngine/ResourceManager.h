@@ -9,6 +9,18 @@ namespace GameEngine{
 		public:
 			static GLTexture getTexture(std::string texturePath);
 
+			/// The id is valid at once and shows a placeholder until the texture is loaded, see TextureCache
+			static GLTexture getTextureAsync(const std::string& texturePath);
+
+			/// The image packed into a shared atlas page, see TextureCache::getAtlasTexture
+			static GLTexture getAtlasTexture(const std::string& texturePath);
+			static GLTexture getAtlasTextureAsync(const std::string& texturePath);
+
+			/// Uploads loaded textures for at most about maxMilliseconds, call it once per frame
+			static void updateTextures(float maxMilliseconds);
+
+			static bool isLoadingTextures();
+
 			//static GLuint boundTexture;
 
 		private:
@@ -0,0 +1,377 @@
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace GameEngine{
+
+	SpatialGrid::SpatialGrid()
+	{
+	}
+
+
+	SpatialGrid::~SpatialGrid()
+	{
+	}
+
+	void SpatialGrid::init(const glm::vec2& origin, const glm::vec2& size, float cellSize){
+		m_origin = origin;
+		m_cellSize = cellSize;
+		m_numXCells = std::max((int)std::ceil(size.x / cellSize), 1);
+		m_numYCells = std::max((int)std::ceil(size.y / cellSize), 1);
+		m_cellStarts.assign(m_numXCells * m_numYCells + 1, 0);
+		clear();
+	}
+
+	void SpatialGrid::clear(){
+		m_boxes.clear();
+		m_cellEntries.clear();
+		m_pairs.clear();
+	}
+
+	int SpatialGrid::add(const glm::vec4& box){
+		m_boxes.push_back(box);
+		return m_boxes.size() - 1;
+	}
+
+	void SpatialGrid::build(){
+		std::fill(m_cellStarts.begin(), m_cellStarts.end(), 0);
+
+		//Count the entries of every cell
+		int numEntries = 0;
+		m_boxCells.resize(m_boxes.size());
+		for (size_t i = 0; i < m_boxes.size(); i++)
+		{
+			glm::ivec4& cells = m_boxCells[i];
+			getCellRange(m_boxes[i], cells.x, cells.y, cells.z, cells.w);
+			for (int y = cells.y; y <= cells.w; y++)
+			{
+				for (int x = cells.x; x <= cells.z; x++)
+				{
+					m_cellStarts[y * m_numXCells + x + 1]++;
+					numEntries++;
+				}
+			}
+		}
+
+		//Prefix sum, afterwards m_cellStarts[cell] is the start of cell
+		for (size_t i = 1; i < m_cellStarts.size(); i++)
+		{
+			m_cellStarts[i] += m_cellStarts[i - 1];
+		}
+
+		m_cellEntries.resize(numEntries);
+
+		//Fill the cells, ids stay sorted inside every cell
+		for (size_t i = 0; i < m_boxes.size(); i++)
+		{
+			const glm::ivec4& cells = m_boxCells[i];
+			for (int y = cells.y; y <= cells.w; y++)
+			{
+				for (int x = cells.x; x <= cells.z; x++)
+				{
+					m_cellEntries[m_cellStarts[y * m_numXCells + x]++] = i;
+				}
+			}
+		}
+
+		//Filling moved every start to the end of its cell, shift them back
+		for (size_t i = m_cellStarts.size() - 1; i > 0; i--)
+		{
+			m_cellStarts[i] = m_cellStarts[i - 1];
+		}
+		m_cellStarts[0] = 0;
+	}
+
+	const int* SpatialGrid::getCellBoxes(int x, int y, int& numBoxes) const {
+		int cell = y * m_numXCells + x;
+		numBoxes = m_cellStarts[cell + 1] - m_cellStarts[cell];
+		return m_cellEntries.data() + m_cellStarts[cell];
+	}
+
+	const std::vector<std::pair<int, int> >& SpatialGrid::findPairs(){
+		m_pairs.clear();
+
+		findPairs(0, m_numYCells, m_pairs);
+
+		std::sort(m_pairs.begin(), m_pairs.end());
+
+		return m_pairs;
+	}
+
+	void SpatialGrid::findPairs(int firstRow, int endRow, std::vector<std::pair<int, int> >& result) const {
+		for (int y = firstRow; y < endRow; y++)
+		{
+			for (int x = 0; x < m_numXCells; x++)
+			{
+				int cell = y * m_numXCells + x;
+				int begin = m_cellStarts[cell];
+				int end = m_cellStarts[cell + 1];
+
+				for (int i = begin; i < end; i++)
+				{
+					const glm::vec4& a = m_boxes[m_cellEntries[i]];
+					for (int j = i + 1; j < end; j++)
+					{
+						const glm::vec4& b = m_boxes[m_cellEntries[j]];
+						if (!overlap(a, b))
+						{
+							continue;
+						}
+
+						//Two boxes can share several cells, only the cell of the overlap's corner reports them
+						int cornerX, cornerY;
+						getCell(glm::vec2(std::max(a.x, b.x), std::max(a.y, b.y)), cornerX, cornerY);
+						if (cornerX == x && cornerY == y)
+						{
+							result.emplace_back(m_cellEntries[i], m_cellEntries[j]);
+						}
+					}
+				}
+			}
+		}
+	}
+
+	void SpatialGrid::query(const glm::vec4& area, std::vector<int>& result) const {
+		result.clear();
+
+		int minX, minY, maxX, maxY;
+		getCellRange(area, minX, minY, maxX, maxY);
+
+		for (int y = minY; y <= maxY; y++)
+		{
+			for (int x = minX; x <= maxX; x++)
+			{
+				int cell = y * m_numXCells + x;
+				for (int i = m_cellStarts[cell]; i < m_cellStarts[cell + 1]; i++)
+				{
+					const glm::vec4& box = m_boxes[m_cellEntries[i]];
+					if (!overlap(area, box))
+					{
+						continue;
+					}
+
+					//Same trick as in findPairs, so every box is only reported once
+					int cornerX, cornerY;
+					getCell(glm::vec2(std::max(area.x, box.x), std::max(area.y, box.y)), cornerX, cornerY);
+					if (cornerX == x && cornerY == y)
+					{
+						result.push_back(m_cellEntries[i]);
+					}
+				}
+			}
+		}
+
+		std::sort(result.begin(), result.end());
+	}
+
+	template<typename Visitor>
+	void SpatialGrid::visitCenters(int x, int y, const glm::vec2& position, Visitor& visit) const {
+		int cell = y * m_numXCells + x;
+		for (int i = m_cellStarts[cell]; i < m_cellStarts[cell + 1]; i++)
+		{
+			int id = m_cellEntries[i];
+			glm::vec2 boxCenter = center(m_boxes[id]);
+
+			//A box is in every cell it touches, but its center is only in one of them
+			int centerX, centerY;
+			getCell(boxCenter, centerX, centerY);
+			if (centerX == x && centerY == y)
+			{
+				glm::vec2 distVec = boxCenter - position;
+				visit(id, glm::dot(distVec, distVec));
+			}
+		}
+	}
+
+	template<typename Visitor>
+	int SpatialGrid::visitRing(int centerX, int centerY, int ring, const glm::vec2& position, Visitor& visit) const {
+		int minY = std::max(centerY - ring, 0);
+		int maxY = std::min(centerY + ring, m_numYCells - 1);
+		int minX = std::max(centerX - ring, 0);
+		int maxX = std::min(centerX + ring, m_numXCells - 1);
+
+		int numCells = 0;
+		for (int y = minY; y <= maxY; y++)
+		{
+			if (y == centerY - ring || y == centerY + ring)
+			{
+				//Top and bottom row of the ring
+				for (int x = minX; x <= maxX; x++)
+				{
+					visitCenters(x, y, position, visit);
+				}
+				numCells += maxX - minX + 1;
+			}
+			else
+			{
+				//Only the left and right column in between
+				if (centerX - ring >= 0)
+				{
+					visitCenters(centerX - ring, y, position, visit);
+					numCells++;
+				}
+				if (ring > 0 && centerX + ring < m_numXCells)
+				{
+					visitCenters(centerX + ring, y, position, visit);
+					numCells++;
+				}
+			}
+		}
+
+		return numCells;
+	}
+
+	int SpatialGrid::findNearest(const glm::vec2& position, float maxDistance, int ignoreId) const {
+		int best = -1;
+		float bestDistance = maxDistance * maxDistance;
+
+		auto visit = [&](int id, float distance){
+			if (id != ignoreId && (distance < bestDistance || (distance == bestDistance && (best == -1 || id < best))))
+			{
+				best = id;
+				bestDistance = distance;
+			}
+		};
+
+		int centerX, centerY;
+		getCell(position, centerX, centerY);
+		int numRings = std::max(std::max(centerX, m_numXCells - 1 - centerX), std::max(centerY, m_numYCells - 1 - centerY));
+
+		int numCellsVisited = 0;
+		for (int ring = 0; ring <= numRings; ring++)
+		{
+			//Every center in this ring is at least ring - 1 whole cells away
+			float minDistance = std::max(ring - 1, 0) * m_cellSize;
+			if (minDistance * minDistance > bestDistance)
+			{
+				break;
+			}
+
+			//With few boxes far away the rings cost more than looking at every box once
+			if (numCellsVisited > (int)m_boxes.size())
+			{
+				for (size_t id = 0; id < m_boxes.size(); id++)
+				{
+					glm::vec2 distVec = center(m_boxes[id]) - position;
+					visit(id, glm::dot(distVec, distVec));
+				}
+				break;
+			}
+
+			numCellsVisited += visitRing(centerX, centerY, ring, position, visit);
+		}
+
+		return best;
+	}
+
+	void SpatialGrid::findKNearest(const glm::vec2& position, int k, float maxDistance, std::vector<int>& result) const {
+		result.clear();
+		if (k <= 0)
+		{
+			return;
+		}
+
+		//Max heap of the best candidates so far, the farthest one is on top
+		m_nearest.clear();
+		float maxDistanceSq = maxDistance * maxDistance;
+
+		auto visit = [&](int id, float distance){
+			if (distance > maxDistanceSq)
+			{
+				return;
+			}
+			std::pair<float, int> candidate(distance, id);
+			if ((int)m_nearest.size() < k)
+			{
+				m_nearest.push_back(candidate);
+				std::push_heap(m_nearest.begin(), m_nearest.end());
+			}
+			else if (candidate < m_nearest.front())
+			{
+				std::pop_heap(m_nearest.begin(), m_nearest.end());
+				m_nearest.back() = candidate;
+				std::push_heap(m_nearest.begin(), m_nearest.end());
+			}
+		};
+
+		int centerX, centerY;
+		getCell(position, centerX, centerY);
+		int numRings = std::max(std::max(centerX, m_numXCells - 1 - centerX), std::max(centerY, m_numYCells - 1 - centerY));
+
+		int numCellsVisited = 0;
+		for (int ring = 0; ring <= numRings; ring++)
+		{
+			float minDistance = std::max(ring - 1, 0) * m_cellSize;
+			if (minDistance * minDistance > maxDistanceSq ||
+				((int)m_nearest.size() == k && minDistance * minDistance > m_nearest.front().first))
+			{
+				break;
+			}
+
+			//Same as in findNearest, start over with every box
+			if (numCellsVisited > (int)m_boxes.size())
+			{
+				m_nearest.clear();
+				for (size_t id = 0; id < m_boxes.size(); id++)
+				{
+					glm::vec2 distVec = center(m_boxes[id]) - position;
+					visit(id, glm::dot(distVec, distVec));
+				}
+				break;
+			}
+
+			numCellsVisited += visitRing(centerX, centerY, ring, position, visit);
+		}
+
+		std::sort_heap(m_nearest.begin(), m_nearest.end());
+		for (auto& candidate : m_nearest)
+		{
+			result.push_back(candidate.second);
+		}
+	}
+
+	void SpatialGrid::findWithinRadius(const glm::vec2& position, float radius, std::vector<int>& result) const {
+		result.clear();
+
+		float radiusSq = radius * radius;
+		auto visit = [&](int id, float distance){
+			if (distance <= radiusSq)
+			{
+				result.push_back(id);
+			}
+		};
+
+		int minX, minY, maxX, maxY;
+		getCellRange(glm::vec4(position - glm::vec2(radius), glm::vec2(radius * 2.0f)), minX, minY, maxX, maxY);
+
+		for (int y = minY; y <= maxY; y++)
+		{
+			for (int x = minX; x <= maxX; x++)
+			{
+				visitCenters(x, y, position, visit);
+			}
+		}
+
+		std::sort(result.begin(), result.end());
+	}
+
+	void SpatialGrid::getCell(const glm::vec2& position, int& x, int& y) const {
+		x = (int)std::floor((position.x - m_origin.x) / m_cellSize);
+		y = (int)std::floor((position.y - m_origin.y) / m_cellSize);
+
+		x = std::min(std::max(x, 0), m_numXCells - 1);
+		y = std::min(std::max(y, 0), m_numYCells - 1);
+	}
+
+	void SpatialGrid::getCellRange(const glm::vec4& box, int& minX, int& minY, int& maxX, int& maxY) const {
+		getCell(glm::vec2(box.x, box.y), minX, minY);
+		getCell(glm::vec2(box.x + box.z, box.y + box.w), maxX, maxY);
+	}
+
+	bool SpatialGrid::overlap(const glm::vec4& a, const glm::vec4& b){
+		return a.x < b.x + b.z && a.x + a.z > b.x &&
+			a.y < b.y + b.w && a.y + a.w > b.y;
+	}
+
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <utility>
+
+namespace GameEngine{
+
+	/// Uniform grid broadphase for axis aligned boxes that is rebuilt every frame.
+	/// Add the boxes, call build() once and then ask for the overlapping pairs, the boxes in an area
+	/// or the boxes nearest to a point.
+	/// The cells are counting sorted into one flat array, so rebuilding doesn't allocate once it is warmed up.
+	/// Boxes outside of the grid bounds end up in the border cells.
+	class SpatialGrid
+	{
+	public:
+		SpatialGrid();
+		~SpatialGrid();
+
+		/// origin and size describe the covered world area, cellSize should be about the size of the boxes
+		void init(const glm::vec2& origin, const glm::vec2& size, float cellSize);
+
+		/// Removes all boxes, the memory is kept for the next frame
+		void clear();
+
+		/// Adds a box (x, y, width, height) and returns its id. Ids count up from 0 in the order of adding
+		int add(const glm::vec4& box);
+
+		/// Sorts the boxes into the cells, call it after the last add()
+		void build();
+
+		/// Every pair of overlapping boxes exactly once, with first < second, sorted by first and then second.
+		/// The vector is reused by the next call
+		const std::vector<std::pair<int, int> >& findPairs();
+
+		/// Appends the overlapping pairs that belong to the cell rows [firstRow, endRow) to result, unsorted.
+		/// Doesn't touch the grid, so several threads can each look at their own rows
+		void findPairs(int firstRow, int endRow, std::vector<std::pair<int, int> >& result) const;
+
+		/// Writes the sorted ids of all boxes overlapping the area into result
+		void query(const glm::vec4& area, std::vector<int>& result) const;
+
+		/// Id of the box whose center is nearest to position and at most maxDistance away, -1 if there is none.
+		/// Equally near boxes go to the smaller id, like a linear scan would. ignoreId is skipped.
+		/// Searches the cells in rings around position and stops as soon as no farther ring can be nearer
+		int findNearest(const glm::vec2& position, float maxDistance, int ignoreId = -1) const;
+
+		/// Writes the ids of the k boxes whose centers are nearest to position and at most maxDistance away
+		/// into result, nearest first
+		void findKNearest(const glm::vec2& position, int k, float maxDistance, std::vector<int>& result) const;
+
+		/// Writes the sorted ids of all boxes whose centers are at most radius away from position into result
+		void findWithinRadius(const glm::vec2& position, float radius, std::vector<int>& result) const;
+
+		/// Sorted ids of the boxes touching the cell, valid until the next build()
+		const int* getCellBoxes(int x, int y, int& numBoxes) const;
+
+		const glm::vec4& getBox(int id) const { return m_boxes[id]; }
+		int getNumBoxes() const { return m_boxes.size(); }
+		int getNumXCells() const { return m_numXCells; }
+		int getNumYCells() const { return m_numYCells; }
+
+	private:
+		void getCell(const glm::vec2& position, int& x, int& y) const;
+		void getCellRange(const glm::vec4& box, int& minX, int& minY, int& maxX, int& maxY) const;
+
+		/// Calls visit(id, squaredDistance) for the boxes with their center in one cell, each box exactly once
+		template<typename Visitor>
+		void visitCenters(int x, int y, const glm::vec2& position, Visitor& visit) const;
+		/// Visits the cells whose distance to the center cell is exactly ring cells, returns how many there were
+		template<typename Visitor>
+		int visitRing(int centerX, int centerY, int ring, const glm::vec2& position, Visitor& visit) const;
+
+		static bool overlap(const glm::vec4& a, const glm::vec4& b);
+		static glm::vec2 center(const glm::vec4& box) { return glm::vec2(box.x + box.z * 0.5f, box.y + box.w * 0.5f); }
+
+		glm::vec2 m_origin = glm::vec2(0.0f);
+		float m_cellSize = 1.0f;
+		int m_numXCells = 1;
+		int m_numYCells = 1;
+
+		std::vector<glm::vec4> m_boxes;
+		std::vector<int> m_cellStarts; ///< Index of the first entry of every cell, one more than cells
+		std::vector<int> m_cellEntries; ///< Box ids ordered by cell, a box is in every cell it touches
+		std::vector<glm::ivec4> m_boxCells; ///< Cell range (minX, minY, maxX, maxY) of every box, from the counting pass of build()
+		std::vector<std::pair<int, int> > m_pairs;
+		mutable std::vector<std::pair<float, int> > m_nearest; ///< Heap of findKNearest, keeps its capacity
+	};
+
+}
@@ -1,5 +1,28 @@
 #include "SpriteBatch.h"
+#include "GameEngineErrors.h"
+#include "Profiler.h"
 #include <algorithm>
+#include <cstring>
+
+namespace {
+
+	//Two triangles per sprite: topLeft, bottomLeft, bottomRight, bottomRight, topRight, topLeft
+	void writeQuad(GameEngine::Vertex* vertices, const GameEngine::Glypth& glypth){
+		vertices[0] = glypth.topLeft;
+		vertices[1] = glypth.bottomLeft;
+		vertices[2] = glypth.bottomRight;
+		vertices[3] = glypth.bottomRight;
+		vertices[4] = glypth.topRight;
+		vertices[5] = glypth.topLeft;
+	}
+
+	//Maps the float bits to an unsigned int with the same ordering
+	uint32_t depthToKey(float depth){
+		uint32_t bits;
+		memcpy(&bits, &depth, sizeof(bits));
+		return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+	}
+}
 
 namespace GameEngine{
 
@@ -65,9 +88,17 @@ namespace GameEngine{
 		return newVector;
 	}
 
+	InstanceGlypth::InstanceGlypth(const glm::vec4& destRect, const glm::vec4& uvRect, GLuint Texture, float Depth, const ColorRGBA8& color, float angle) : texture(Texture), depth(Depth){
+		instance.destRect = destRect;
+		instance.uvRect = uvRect;
+		instance.color = color;
+		instance.angle = angle;
+		instance.depth = Depth;
+	}
+
 
 
-	SpriteBatch::SpriteBatch(void) : m_vbo(0), m_vao(0)
+	SpriteBatch::SpriteBatch(void) : m_vao(0)
 	{
 	}
 
@@ -77,36 +108,145 @@ namespace GameEngine{
 	}
 
 
-	void SpriteBatch::init(){
+	void SpriteBatch::init(SpriteBatchMode mode /* = SpriteBatchMode::VERTICES */){
+		m_mode = mode;
+		m_streamBuffer.init(GL_ARRAY_BUFFER);
 		createVertexArray();
 
 	}
 
+	void SpriteBatch::dispose(){
+		m_streamBuffer.dispose();
+
+		if (m_staticVbo != 0)
+		{
+			glDeleteBuffers(1, &m_staticVbo);
+			m_staticVbo = 0;
+		}
+		if (m_vao != 0)
+		{
+			glDeleteVertexArrays(1, &m_vao);
+			m_vao = 0;
+		}
+
+		//Nothing left to draw from
+		m_renderBatches.clear();
+		m_isStatic = false;
+	}
+
+	void SpriteBatch::initHeadless(SpriteBatchMode mode){
+		m_mode = mode;
+	}
+
 	void SpriteBatch::begin(GlypthSortType sortType) /* = GlypthSortType::TEXTURE) */{
 		m_sortType = sortType;
+		m_isStatic = false;
+		m_staticDirty = false;
 		m_renderBatches.clear();
 		m_glypths.clear();
+		m_instanceGlypths.clear();
+		m_sortKeys.clear();
 	}
 
 	void SpriteBatch::end(){
-		//Set up all pointers for fast sorting
-		m_glypthPointers.resize(m_glypths.size());
-		for (int i = 0; i < m_glypths.size(); i++)
+		PROFILE_ZONE("SpriteBatch::end");
+
+		sortGlypths();
+
+		m_uploadedBytes = getVertexDataSize();
+		if (m_uploadedBytes == 0)
 		{
-			m_glypthPointers[i] = &m_glypths[i];
+			return;
 		}
+
+		//Write straight into the stream buffer, no temporary vertex vector
+		createBatches(m_streamBuffer.map(m_uploadedBytes));
+		m_streamBuffer.unmap();
+	}
+
+	void SpriteBatch::buildBatches(std::vector<unsigned char>& data){
 		sortGlypths();
-		createRenderBatches();
 
+		m_uploadedBytes = getVertexDataSize();
+		data.resize(m_uploadedBytes);
+		if (m_uploadedBytes == 0)
+		{
+			return;
+		}
+
+		createBatches(data.data());
+	}
+
+	void SpriteBatch::endStatic(){
+		m_isStatic = true;
+		uploadStaticLayer();
+	}
+
+	void SpriteBatch::updateStaticSprite(size_t index, const glm::vec4& destRect, const glm::vec4& uvRect, GLuint texture, float depth, const ColorRGBA8& color){
+		if (m_isStatic == false || index >= m_staticPositions.size())
+		{
+			fatalError("SpriteBatch::updateStaticSprite called with an invalid sprite index");
+		}
+
+		GLuint oldTexture;
+		if (m_mode == SpriteBatchMode::INSTANCED)
+		{
+			oldTexture = m_instanceGlypths[index].texture;
+			m_instanceGlypths[index] = InstanceGlypth(destRect, uvRect, texture, depth, color, 0.0f);
+		}
+		else{
+			oldTexture = m_glypths[index].texture;
+			m_glypths[index] = Glypth(destRect, uvRect, texture, depth, color);
+		}
+
+		GlypthSortKey& sortKey = m_sortKeys[m_staticPositions[index]];
+		uint64_t newKey = makeSortKey(m_sortType, texture, depth);
+
+		//A new texture or draw order changes the batches, so rebuild the layer before the next render
+		if (m_staticDirty || newKey != sortKey.key || texture != oldTexture)
+		{
+			sortKey.key = newKey;
+			m_staticDirty = true;
+			return;
+		}
+
+		//Otherwise the sprite keeps its slot and only its own bytes are rewritten
+		const GLuint position = m_staticPositions[index];
+		glBindBuffer(GL_ARRAY_BUFFER, m_staticVbo);
+		if (m_mode == SpriteBatchMode::INSTANCED)
+		{
+			glBufferSubData(GL_ARRAY_BUFFER, position * sizeof(SpriteInstance), sizeof(SpriteInstance), &m_instanceGlypths[index].instance);
+		}
+		else{
+			Vertex quad[6];
+			writeQuad(quad, m_glypths[index]);
+			glBufferSubData(GL_ARRAY_BUFFER, position * sizeof(quad), sizeof(quad), quad);
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
 	}
 
 	void SpriteBatch::draw(const glm::vec4& destRect, const glm::vec4& uvRect, GLuint texture, float depth, const ColorRGBA8& color){
+		addSortKey(texture, depth);
+
+		if (m_mode == SpriteBatchMode::INSTANCED)
+		{
+			m_instanceGlypths.emplace_back(destRect, uvRect, texture, depth, color, 0.0f);
+			return;
+		}
 
 		m_glypths.emplace_back(destRect, uvRect, texture, depth, color);
 	}
 
 
 	void SpriteBatch::draw(const glm::vec4& destRect, const glm::vec4& uvRect, GLuint texture, float depth, const ColorRGBA8& color, float angle) {
+		addSortKey(texture, depth);
+
+		if (m_mode == SpriteBatchMode::INSTANCED)
+		{
+			m_instanceGlypths.emplace_back(destRect, uvRect, texture, depth, color, angle);
+			return;
+		}
+
 		m_glypths.emplace_back(destRect, uvRect, texture, depth, color, angle);
 	}
 
@@ -120,14 +260,42 @@ namespace GameEngine{
 			angle = -angle;
 		}
 
-		m_glypths.emplace_back(destRect, uvRect, texture, depth, color, angle);
+		draw(destRect, uvRect, texture, depth, color, angle);
 	}
 
 
 
 	void SpriteBatch::renderBatch(){
+		PROFILE_ZONE("SpriteBatch::renderBatch");
+
+		if (m_staticDirty)
+		{
+			uploadStaticLayer();
+		}
+
+		//The stream buffer hands out a different region (or buffer) every frame
+		const GLuint buffer = m_isStatic ? m_staticVbo : m_streamBuffer.getID();
+		const size_t base = m_isStatic ? 0 : m_streamBuffer.getOffset();
 
 		glBindVertexArray(m_vao);
+		glBindBuffer(GL_ARRAY_BUFFER, buffer);
+
+		if (m_mode == SpriteBatchMode::INSTANCED)
+		{
+			for (int i = 0; i < m_renderBatches.size(); i++)
+			{
+				glBindTexture(GL_TEXTURE_2D, m_renderBatches[i].texture);
+
+				//Without base instance support the attribute pointers have to start at the batch
+				setInstanceAttribPointers(base + m_renderBatches[i].offset * sizeof(SpriteInstance));
+				glDrawArraysInstanced(GL_TRIANGLES, 0, 6, m_renderBatches[i].numVertices);
+			}
+			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			glBindVertexArray(0);
+			return;
+		}
+
+		setVertexAttribPointers(base);
 
 		for (int i = 0; i < m_renderBatches.size(); i++)
 		{
@@ -136,28 +304,71 @@ namespace GameEngine{
 			glDrawArrays(GL_TRIANGLES, m_renderBatches[i].offset, m_renderBatches[i].numVertices);
 		}
 
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
 		glBindVertexArray(0);
 	}
 
-	void SpriteBatch::createRenderBatches(){
-		std::vector<Vertex> vertices;
-		vertices.resize(m_glypthPointers.size() * 6);
+	bool SpriteBatch::isInstancingSupported(){
+		return GLEW_VERSION_3_3 == GL_TRUE;
+	}
 
-		if (m_glypthPointers.empty())
+	size_t SpriteBatch::getVertexDataSize() const{
+		if (m_mode == SpriteBatchMode::INSTANCED)
 		{
+			return m_instanceGlypths.size() * sizeof(SpriteInstance);
+		}
+		return m_glypths.size() * 6 * sizeof(Vertex);
+	}
+
+	void SpriteBatch::createBatches(void* data){
+		if (m_mode == SpriteBatchMode::INSTANCED)
+		{
+			setSortedPointers(m_instanceGlypths, m_instanceGlypthPointers);
+			createInstanceBatches((SpriteInstance*)data);
 			return;
 		}
 
+		setSortedPointers(m_glypths, m_glypthPointers);
+		createRenderBatches((Vertex*)data);
+	}
+
+	void SpriteBatch::uploadStaticLayer(){
+		m_staticDirty = false;
+		m_renderBatches.clear();
+
+		sortGlypths();
+
+		//Remember where every sprite ended up so it can be patched later
+		m_staticPositions.resize(m_sortKeys.size());
+		for (size_t i = 0; i < m_sortKeys.size(); i++)
+		{
+			m_staticPositions[m_sortKeys[i].index] = (GLuint)i;
+		}
+
+		m_uploadedBytes = getVertexDataSize();
+		if (m_uploadedBytes == 0)
+		{
+			return;
+		}
+
+		m_staticData.resize(m_uploadedBytes);
+		createBatches(m_staticData.data());
+
+		if (m_staticVbo == 0)
+		{
+			glGenBuffers(1, &m_staticVbo);
+		}
+
+		glBindBuffer(GL_ARRAY_BUFFER, m_staticVbo);
+		glBufferData(GL_ARRAY_BUFFER, m_uploadedBytes, m_staticData.data(), GL_DYNAMIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+
+	void SpriteBatch::createRenderBatches(Vertex* vertices){
 		int offset = 0;
-		int cv = 0; //current vertex
 
 		m_renderBatches.emplace_back(offset, 6, m_glypthPointers[0]->texture);
-		vertices[cv++] = m_glypthPointers[0]->topLeft;
-		vertices[cv++] = m_glypthPointers[0]->bottomLeft;
-		vertices[cv++] = m_glypthPointers[0]->bottomRight;
-		vertices[cv++] = m_glypthPointers[0]->bottomRight;
-		vertices[cv++] = m_glypthPointers[0]->topRight;
-		vertices[cv++] = m_glypthPointers[0]->topLeft;
+		writeQuad(vertices, *m_glypthPointers[0]);
 		offset += 6;
 
 		for (int cg = 1; cg < m_glypthPointers.size(); cg++) //cg = current Glypth
@@ -169,27 +380,26 @@ namespace GameEngine{
 			else{
 				m_renderBatches.back().numVertices += 6;
 			}
-			vertices[cv++] = m_glypthPointers[cg]->topLeft;
-			vertices[cv++] = m_glypthPointers[cg]->bottomLeft;
-			vertices[cv++] = m_glypthPointers[cg]->bottomRight;
-			vertices[cv++] = m_glypthPointers[cg]->bottomRight;
-			vertices[cv++] = m_glypthPointers[cg]->topRight;
-			vertices[cv++] = m_glypthPointers[cg]->topLeft;
+			writeQuad(vertices + offset, *m_glypthPointers[cg]);
 			offset += 6;
 		}
+	}
 
-		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-		//glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), vertices.data(), GL_DYNAMIC_DRAW); faster way -->
-		//orphan the buffer
-		glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(Vertex), nullptr, GL_DYNAMIC_DRAW);
-		//upload the data
-		glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(Vertex), vertices.data());
-
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-
-
+	void SpriteBatch::createInstanceBatches(SpriteInstance* instances){
+		m_renderBatches.emplace_back(0, 1, m_instanceGlypthPointers[0]->texture);
+		instances[0] = m_instanceGlypthPointers[0]->instance;
 
+		for (int cg = 1; cg < m_instanceGlypthPointers.size(); cg++) //cg = current Glypth
+		{
+			if (m_instanceGlypthPointers[cg]->texture != m_instanceGlypthPointers[cg - 1]->texture)
+			{
+				m_renderBatches.emplace_back(cg, 1, m_instanceGlypthPointers[cg]->texture);
+			}
+			else{
+				m_renderBatches.back().numVertices++;
+			}
+			instances[cg] = m_instanceGlypthPointers[cg]->instance;
+		}
 	}
 
 	void SpriteBatch::createVertexArray(){
@@ -201,59 +411,158 @@ namespace GameEngine{
 
 		glBindVertexArray(m_vao);
 
-		if (m_vbo == 0)
+		if (m_mode == SpriteBatchMode::INSTANCED)
 		{
-			glGenBuffers(1, &m_vbo);
+			glEnableVertexAttribArray(0);
+			glEnableVertexAttribArray(1);
+			glEnableVertexAttribArray(2);
+			glEnableVertexAttribArray(3);
+
+			//Advance every attribute once per sprite instead of once per vertex
+			glVertexAttribDivisor(0, 1);
+			glVertexAttribDivisor(1, 1);
+			glVertexAttribDivisor(2, 1);
+			glVertexAttribDivisor(3, 1);
+
+			glBindVertexArray(0);
+			return;
 		}
 
-		glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
-
-
 		glEnableVertexAttribArray(0);
 		glEnableVertexAttribArray(1);
 		glEnableVertexAttribArray(2);
 
+		//The attribute pointers are set in renderBatch() because the buffer region changes every frame
+		glBindVertexArray(0);
+
+	}
+
+	void SpriteBatch::setVertexAttribPointers(size_t base){
+		//Expects the stream buffer to be bound to GL_ARRAY_BUFFER
+
 		//tells openGl where the data is
 		//this is the position attribute pointer
-		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, position));
+		glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(base + offsetof(Vertex, position)));
 
 		//This is the color attribute pointer
-		glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)offsetof(Vertex, color));
+		glVertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), (void*)(base + offsetof(Vertex, color)));
 
 		//This is the UV attribute pointer
-		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, uv));
+		glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)(base + offsetof(Vertex, uv)));
+	}
 
-		glBindVertexArray(0);
+	void SpriteBatch::setInstanceAttribPointers(size_t base){
+		//Expects the stream buffer to be bound to GL_ARRAY_BUFFER
 
+		//This is the destRect attribute pointer
+		glVertexAttribPointer(0, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(base + offsetof(SpriteInstance, destRect)));
+
+		//This is the UV rect attribute pointer
+		glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(base + offsetof(SpriteInstance, uvRect)));
+
+		//This is the color attribute pointer
+		glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(SpriteInstance), (void*)(base + offsetof(SpriteInstance, color)));
+
+		//Angle and depth are next to each other, so they share one attribute
+		glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(SpriteInstance), (void*)(base + offsetof(SpriteInstance, angle)));
 	}
 
-	void SpriteBatch::sortGlypths(){
-		switch (m_sortType)
+	//Passes where every key has the same digit are skipped
+	void SpriteBatch::radixSort(std::vector<GlypthSortKey>& keys, std::vector<GlypthSortKey>& temp){
+		const size_t numKeys = keys.size();
+		if (numKeys < 2)
+		{
+			return;
+		}
+
+		static const int NUM_PASSES = 8;
+		uint32_t histograms[NUM_PASSES][256];
+		memset(histograms, 0, sizeof(histograms));
+
+		//Build every histogram in one read over the keys
+		for (size_t i = 0; i < numKeys; i++)
+		{
+			uint64_t key = keys[i].key;
+			for (int pass = 0; pass < NUM_PASSES; pass++)
+			{
+				histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+			}
+		}
+
+		temp.resize(numKeys);
+		GlypthSortKey* src = keys.data();
+		GlypthSortKey* dst = temp.data();
+
+		for (int pass = 0; pass < NUM_PASSES; pass++)
+		{
+			uint32_t* histogram = histograms[pass];
+			const int shift = pass * 8;
+
+			if (histogram[(src[0].key >> shift) & 0xFF] == numKeys)
+			{
+				continue;
+			}
+
+			//Turn the counts into start offsets
+			uint32_t sum = 0;
+			for (int digit = 0; digit < 256; digit++)
+			{
+				uint32_t count = histogram[digit];
+				histogram[digit] = sum;
+				sum += count;
+			}
+
+			for (size_t i = 0; i < numKeys; i++)
+			{
+				dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+			}
+
+			std::swap(src, dst);
+		}
+
+		if (src != keys.data())
+		{
+			keys.swap(temp);
+		}
+	}
+
+	uint64_t SpriteBatch::makeSortKey(GlypthSortType sortType, GLuint texture, float depth){
+		switch (sortType)
 		{
 		case GameEngine::GlypthSortType::FRONT_TO_BACK:
-			std::stable_sort(m_glypthPointers.begin(), m_glypthPointers.end(), compareFrontToBack);
-			break;
+			return depthToKey(depth);
 		case GameEngine::GlypthSortType::BACK_TO_FRONT:
-			std::stable_sort(m_glypthPointers.begin(), m_glypthPointers.end(), compareFrontToBack);
-			break;
+			return ~depthToKey(depth);
 		case GameEngine::GlypthSortType::TEXTURE:
-			std::stable_sort(m_glypthPointers.begin(), m_glypthPointers.end(), compareTexture);
-			break;
+			return texture;
+		case GameEngine::GlypthSortType::DEPTH_TEXTURE:
+			return ((uint64_t)depthToKey(depth) << 32) | texture;
 		default:
-			break;
+			return 0;
 		}
 	}
 
-	bool SpriteBatch::compareFrontToBack(Glypth* a, Glypth* b){
-		return (a->depth < b->depth);
+	void SpriteBatch::addSortKey(GLuint texture, float depth){
+		GlypthSortKey sortKey;
+		sortKey.key = makeSortKey(m_sortType, texture, depth);
+		sortKey.index = (uint32_t)m_sortKeys.size();
+		m_sortKeys.push_back(sortKey);
 	}
 
-	bool SpriteBatch::compareBackToFront(Glypth* a, Glypth* b){
-		return (a->depth > b->depth);
+	void SpriteBatch::sortGlypths(){
+		if (m_sortType != GlypthSortType::NONE)
+		{
+			radixSort(m_sortKeys, m_sortKeysTemp);
+		}
 	}
 
-	bool SpriteBatch::compareTexture(Glypth* a, Glypth* b){
-		return (a->texture < b->texture);
+	template<typename T>
+	void SpriteBatch::setSortedPointers(std::vector<T>& glypths, std::vector<T*>& glypthPointers){
+		glypthPointers.resize(m_sortKeys.size());
+		for (size_t i = 0; i < m_sortKeys.size(); i++)
+		{
+			glypthPointers[i] = &glypths[m_sortKeys[i].index];
+		}
 	}
 
 
@@ -3,8 +3,10 @@
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 #include <vector>
+#include <cstdint>
 
 #include "Vertex.h"
+#include "StreamBuffer.h"
 
 namespace GameEngine{
 
@@ -12,7 +14,29 @@ namespace GameEngine{
 		NONE,
 		FRONT_TO_BACK,
 		BACK_TO_FRONT,
-		TEXTURE
+		TEXTURE,
+		DEPTH_TEXTURE ///< Front to back, sprites with the same depth are grouped by texture
+		};
+
+	/// Packed sort key of one draw call. Equal keys keep their submission order
+	struct GlypthSortKey{
+		uint64_t key; ///< High 32 bits: depth, low 32 bits: texture (depending on GlypthSortType)
+		uint32_t index; ///< Submission index into the glypth vector
+		};
+
+	enum class SpriteBatchMode{
+		VERTICES, ///< Six vertices per sprite, built on the CPU
+		INSTANCED ///< One SpriteInstance per sprite, the quad is expanded in the vertex shader
+		};
+
+	/// Per sprite record that is uploaded in SpriteBatchMode::INSTANCED.
+	/// Attribute locations: 0 = destRect, 1 = uvRect, 2 = color, 3 = angle and depth
+	struct SpriteInstance{
+		glm::vec4 destRect;
+		glm::vec4 uvRect;
+		ColorRGBA8 color;
+		float angle;
+		float depth;
 		};
 
 	class Glypth {
@@ -37,6 +61,17 @@ namespace GameEngine{
 
 		};
 
+	class InstanceGlypth {
+	public:
+		InstanceGlypth(const glm::vec4& destRect, const glm::vec4& uvRect, GLuint Texture, float Depth, const ColorRGBA8& color, float angle);
+
+		GLuint texture;
+		float depth;
+
+		SpriteInstance instance;
+		};
+
+	/// In SpriteBatchMode::INSTANCED offset and numVertices count instances instead of vertices
 	class RenderBatch {
 	public:
 		RenderBatch(GLuint Offset, GLuint NumVertices, GLuint Texture) : 
@@ -56,11 +91,21 @@ namespace GameEngine{
 			SpriteBatch(void);
 			~SpriteBatch(void);
 
-			void init(); //1
+			void init(SpriteBatchMode mode = SpriteBatchMode::VERTICES); //1
+
+			/// Deletes the stream buffer, the static buffer and the vertex array. init() makes the batch usable again
+			void dispose();
+
+			/// Sets the mode without creating any GL objects. Such a batch can't render,
+			/// it only builds its data with buildBatches() (used by the benchmarks)
+			void initHeadless(SpriteBatchMode mode);
 
 			void begin(GlypthSortType sortType = GlypthSortType::TEXTURE); //2
 			void end(); //4
 
+			/// The CPU half of end(): sorts the glypths and writes the vertices or instances into data, no GL calls
+			void buildBatches(std::vector<unsigned char>& data);
+
 			void draw(const glm::vec4& destRect, const glm::vec4& uvRect, GLuint texture, float depth, const ColorRGBA8& color); //3
 
 			void draw(const glm::vec4& destRect, const glm::vec4& uvRect, GLuint texture, float depth, const ColorRGBA8& color, float angle); //3
@@ -69,23 +114,66 @@ namespace GameEngine{
 
 			void renderBatch(); //5
 
+			/// Retained static layer: begin(), draw() every sprite once, then endStatic() instead of end().
+			/// The sprites stay on the GPU until the next begin(), renderBatch() draws them without uploading.
+			void endStatic();
+
+			/// Changes one sprite of the static layer, index is the order of its draw() call.
+			/// The quad is patched in place unless its texture or draw order changes,
+			/// then the layer is rebuilt once before the next renderBatch()
+			void updateStaticSprite(size_t index, const glm::vec4& destRect, const glm::vec4& uvRect, GLuint texture, float depth, const ColorRGBA8& color);
+
+			//Returns true if the driver can draw SpriteBatchMode::INSTANCED (OpenGL 3.3)
+			static bool isInstancingSupported();
+
+			SpriteBatchMode getMode() const { return m_mode; }
+
+			//Returns the number of bytes uploaded by the last end()
+			size_t getUploadedBytes() const { return m_uploadedBytes; }
+
+			size_t getNumRenderBatches() const { return m_renderBatches.size(); }
+
+			/// Sort key of one draw() call, equal keys keep their draw order
+			static uint64_t makeSortKey(GlypthSortType sortType, GLuint texture, float depth);
+
+			/// The sort of end() and endStatic(): stable LSD radix sort by key, 8 bits per pass, temp is scratch memory
+			static void radixSort(std::vector<GlypthSortKey>& keys, std::vector<GlypthSortKey>& temp);
+
 		private: 
-			void createRenderBatches();
+			size_t getVertexDataSize() const;
+			void createBatches(void* data);
+			void createRenderBatches(Vertex* vertices);
+			void createInstanceBatches(SpriteInstance* instances);
+			void uploadStaticLayer();
 			void createVertexArray();
+			void setVertexAttribPointers(size_t base);
+			void setInstanceAttribPointers(size_t base);
+
+			void addSortKey(GLuint texture, float depth);
 			void sortGlypths();
 
-			static bool compareFrontToBack(Glypth* a, Glypth* b);
-			static bool compareBackToFront(Glypth* a, Glypth* b);
-			static bool compareTexture(Glypth* a, Glypth* b);
+			template<typename T>
+			void setSortedPointers(std::vector<T>& glypths, std::vector<T*>& glypthPointers);
 
-			GLuint m_vbo;
+			StreamBuffer m_streamBuffer;
 			GLuint m_vao;
+			GLuint m_staticVbo = 0;
 
+			SpriteBatchMode m_mode = SpriteBatchMode::VERTICES;
 			GlypthSortType m_sortType;
+			size_t m_uploadedBytes = 0;
+			bool m_isStatic = false; ///< Renders the retained static layer instead of the stream buffer
+			bool m_staticDirty = false;
 
 			std::vector<Glypth*> m_glypthPointers; ///< This is for sorting
 			std::vector<Glypth> m_glypths; ///< these are the actual glypths
+			std::vector<InstanceGlypth*> m_instanceGlypthPointers; ///< Sorting for SpriteBatchMode::INSTANCED
+			std::vector<InstanceGlypth> m_instanceGlypths; ///< Glypths for SpriteBatchMode::INSTANCED
+			std::vector<GlypthSortKey> m_sortKeys; ///< One key per draw, radix sorted in end()
+			std::vector<GlypthSortKey> m_sortKeysTemp; ///< Scratch buffer of the radix sort
 			std::vector<RenderBatch> m_renderBatches;
+			std::vector<GLuint> m_staticPositions; ///< Sorted slot of every static sprite, indexed by draw order
+			std::vector<unsigned char> m_staticData; ///< CPU copy used when the static layer is rebuilt
 		};
 
 
@@ -1,6 +1,7 @@
 #include "SpriteFont.h"
 
 #include "SpriteBatch.h"
+#include "IOManager.h"
 
 #include <SDL/SDL.h>
 
@@ -26,7 +27,12 @@ namespace GameEngine {
         if (!TTF_WasInit()) {
             TTF_Init();
         }
-        TTF_Font* f = TTF_OpenFont(font, size);
+        // The font reads glyphs from the file until it is closed at the end
+        FileView file;
+        TTF_Font* f = nullptr;
+        if (file.open(font)) {
+            f = TTF_OpenFontRW(SDL_RWFromConstMem(file.data(), (int)file.size()), 1, size);
+        }
         if (f == nullptr) {
             fprintf(stderr, "Failed to open TTF font %s\n", font);
             fflush(stderr);
@@ -0,0 +1,184 @@
+#include "StreamBuffer.h"
+
+namespace {
+	//Region starts are kept aligned so every vertex layout can start at a region
+	const size_t REGION_ALIGNMENT = 256;
+
+	size_t alignRegionSize(size_t size){
+		return (size + REGION_ALIGNMENT - 1) / REGION_ALIGNMENT * REGION_ALIGNMENT;
+	}
+}
+
+namespace GameEngine{
+
+	StreamBuffer::StreamBuffer()
+	{
+		for (int i = 0; i < NUM_REGIONS; i++)
+		{
+			m_fences[i] = nullptr;
+		}
+	}
+
+
+	StreamBuffer::~StreamBuffer()
+	{
+		//The GL context may already be gone here, so the owner has to call dispose()
+	}
+
+	void StreamBuffer::init(GLenum target, size_t regionSize /* = 64 * 1024 */){
+		//Can be called again, e.g. when a SpriteBatch is reinitialised
+		if (m_id != 0)
+		{
+			return;
+		}
+
+		m_target = target;
+		m_persistent = (GLEW_ARB_buffer_storage == GL_TRUE) && (GLEW_ARB_sync == GL_TRUE);
+
+		createBuffer(regionSize);
+	}
+
+	void* StreamBuffer::map(size_t numBytes){
+		m_mappedBytes = numBytes;
+
+		if (!m_persistent)
+		{
+			//Keep the staging memory around so it only grows
+			if (m_staging.size() < numBytes)
+			{
+				m_staging.resize(numBytes);
+			}
+			m_offset = 0;
+			return m_staging.data();
+		}
+
+		if (m_currentRegion >= 0)
+		{
+			//Every command that reads the previous region has been issued by now
+			if (m_fences[m_currentRegion])
+			{
+				glDeleteSync(m_fences[m_currentRegion]);
+			}
+			m_fences[m_currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		}
+
+		if (numBytes > m_regionSize)
+		{
+			//GL keeps the old storage alive until pending draws are done with it
+			size_t newSize = m_regionSize * 2;
+			if (newSize < numBytes)
+			{
+				newSize = numBytes;
+			}
+			destroyBuffer();
+			createBuffer(newSize);
+		}
+
+		m_currentRegion = (m_currentRegion + 1) % NUM_REGIONS;
+		waitForRegion(m_currentRegion);
+
+		m_offset = m_currentRegion * m_regionSize;
+		return m_persistentData + m_offset;
+	}
+
+	void StreamBuffer::unmap(){
+		if (m_persistent)
+		{
+			//The mapping is coherent, the data is already visible to the GPU
+			return;
+		}
+
+		glBindBuffer(m_target, m_id);
+		//orphan the buffer
+		glBufferData(m_target, m_mappedBytes, nullptr, GL_DYNAMIC_DRAW);
+		//upload the data
+		glBufferSubData(m_target, 0, m_mappedBytes, m_staging.data());
+		glBindBuffer(m_target, 0);
+	}
+
+	void StreamBuffer::dispose(){
+		destroyBuffer();
+		m_regionSize = 0;
+		m_staging.clear();
+		m_staging.shrink_to_fit();
+	}
+
+	void StreamBuffer::createBuffer(size_t regionSize){
+		m_regionSize = alignRegionSize(regionSize);
+		m_currentRegion = -1;
+		m_offset = 0;
+
+		glGenBuffers(1, &m_id);
+		glBindBuffer(m_target, m_id);
+
+		if (m_persistent)
+		{
+			const GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+			const size_t bufferSize = m_regionSize * NUM_REGIONS;
+
+			glBufferStorage(m_target, bufferSize, nullptr, flags);
+			m_persistentData = (unsigned char*)glMapBufferRange(m_target, 0, bufferSize, flags);
+
+			if (m_persistentData == nullptr)
+			{
+				//Driver advertised the extension but refused the mapping, use the old path instead
+				m_persistent = false;
+				glBindBuffer(m_target, 0);
+				glDeleteBuffers(1, &m_id);
+				glGenBuffers(1, &m_id);
+			}
+		}
+
+		glBindBuffer(m_target, 0);
+	}
+
+	void StreamBuffer::destroyBuffer(){
+		for (int i = 0; i < NUM_REGIONS; i++)
+		{
+			if (m_fences[i])
+			{
+				glDeleteSync(m_fences[i]);
+				m_fences[i] = nullptr;
+			}
+		}
+
+		if (m_id)
+		{
+			if (m_persistentData)
+			{
+				glBindBuffer(m_target, m_id);
+				glUnmapBuffer(m_target);
+				glBindBuffer(m_target, 0);
+				m_persistentData = nullptr;
+			}
+			glDeleteBuffers(1, &m_id);
+			m_id = 0;
+		}
+	}
+
+	void StreamBuffer::waitForRegion(int region){
+		GLsync fence = m_fences[region];
+		if (fence == nullptr)
+		{
+			return;
+		}
+
+		//Flush on the first try so the fence can signal at all, then wait in 1ms steps
+		GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+		GLuint64 timeout = 0;
+		while (true)
+		{
+			GLenum result = glClientWaitSync(fence, waitFlags, timeout);
+			if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+			{
+				break;
+			}
+			waitFlags = 0;
+			timeout = 1000000;
+		}
+
+		glDeleteSync(fence);
+		m_fences[region] = nullptr;
+	}
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <GL/glew.h>
+#include <vector>
+
+namespace GameEngine{
+
+	/// Triple buffered buffer for data that is rewritten every frame.
+	/// Uses a persistently mapped buffer (GL_ARB_buffer_storage) with one fence per region
+	/// and falls back to orphaning + glBufferSubData when the extension is missing.
+	class StreamBuffer
+	{
+	public:
+		StreamBuffer();
+		~StreamBuffer();
+
+		void init(GLenum target, size_t regionSize = 64 * 1024);
+
+		/// Returns memory to write numBytes into, it stays valid until unmap()
+		void* map(size_t numBytes);
+
+		/// Finishes the write started by map()
+		void unmap();
+
+		void dispose();
+
+		GLuint getID() const { return m_id; }
+
+		/// Byte offset of the last mapped range inside the buffer
+		size_t getOffset() const { return m_offset; }
+
+		bool isPersistent() const { return m_persistent; }
+
+	private:
+		void createBuffer(size_t regionSize);
+		void destroyBuffer();
+		void waitForRegion(int region);
+
+		static const int NUM_REGIONS = 3;
+
+		GLenum m_target = GL_ARRAY_BUFFER;
+		GLuint m_id = 0;
+		bool m_persistent = false;
+
+		size_t m_regionSize = 0;
+		int m_currentRegion = -1;
+		size_t m_offset = 0;
+		size_t m_mappedBytes = 0;
+
+		unsigned char* m_persistentData = nullptr; ///< Start of the persistent mapping
+		GLsync m_fences[NUM_REGIONS];
+		std::vector<unsigned char> m_staging; ///< Only used by the fallback path
+	};
+
+}
@@ -0,0 +1,193 @@
+#include "TextureAtlas.h"
+
+#include <algorithm>
+
+namespace GameEngine{
+
+	const int PAGE_SIZE = 1024;
+	const int BORDER = 4; ///< Pixels repeated around every image, keeps mip levels 0 to 2 clean
+	const int MAX_MIP_LEVEL = 2;
+
+	TextureAtlas::TextureAtlas()
+	{
+	}
+
+
+	TextureAtlas::~TextureAtlas()
+	{
+	}
+
+	void TextureAtlas::dispose(){
+		for (auto& page : m_pages)
+		{
+			glDeleteTextures(1, &page.id);
+		}
+		m_pages.clear();
+	}
+
+	bool TextureAtlas::reserve(int width, int height, AtlasRegion& region){
+		int paddedWidth = width + BORDER * 2;
+		int paddedHeight = height + BORDER * 2;
+		if (width <= 0 || height <= 0 || paddedWidth > PAGE_SIZE || paddedHeight > PAGE_SIZE)
+		{
+			return false;
+		}
+
+		int x, y;
+		for (size_t i = 0; i < m_pages.size(); i++)
+		{
+			if (insert(m_pages[i], paddedWidth, paddedHeight, x, y))
+			{
+				region = { (int)i, x + BORDER, y + BORDER, width, height };
+				return true;
+			}
+		}
+
+		addPage();
+		insert(m_pages.back(), paddedWidth, paddedHeight, x, y);
+		region = { (int)m_pages.size() - 1, x + BORDER, y + BORDER, width, height };
+		return true;
+	}
+
+	void TextureAtlas::upload(const AtlasRegion& region, const Image& image){
+		int paddedWidth = region.width + BORDER * 2;
+		int paddedHeight = region.height + BORDER * 2;
+		m_uploadBuffer.resize((size_t)paddedWidth * paddedHeight * 4);
+
+		//Level 0 of the image with its edge pixels repeated into the border
+		for (int y = 0; y < paddedHeight; y++)
+		{
+			int sourceY = std::min(std::max(y - BORDER, 0), region.height - 1);
+			const unsigned char* sourceRow = image.data + (size_t)sourceY * region.width * 4;
+			unsigned char* row = &m_uploadBuffer[(size_t)y * paddedWidth * 4];
+			for (int x = 0; x < paddedWidth; x++)
+			{
+				int sourceX = std::min(std::max(x - BORDER, 0), region.width - 1);
+				std::copy(sourceRow + sourceX * 4, sourceRow + sourceX * 4 + 4, row + x * 4);
+			}
+		}
+
+		glBindTexture(GL_TEXTURE_2D, m_pages[region.page].id);
+		glTexSubImage2D(GL_TEXTURE_2D, 0, region.x - BORDER, region.y - BORDER, paddedWidth, paddedHeight, GL_RGBA, GL_UNSIGNED_BYTE, m_uploadBuffer.data());
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, 0);
+	}
+
+	GLTexture TextureAtlas::getTexture(const AtlasRegion& region) const {
+		GLTexture texture = {};
+		texture.id = m_pages[region.page].id;
+		texture.width = region.width;
+		texture.height = region.height;
+		texture.uvRect = glm::vec4(region.x, region.y, region.width, region.height) / (float)PAGE_SIZE;
+		return texture;
+	}
+
+	void TextureAtlas::addPage(){
+		Page page;
+		page.skyline.push_back({ 0, 0, PAGE_SIZE });
+
+		//Starts out transparent, so a region shows nothing until its image is uploaded
+		std::vector<unsigned char> pixels((size_t)PAGE_SIZE * PAGE_SIZE * 4, 0);
+
+		glGenTextures(1, &page.id);
+		glBindTexture(GL_TEXTURE_2D, page.id);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, PAGE_SIZE, PAGE_SIZE, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, MAX_MIP_LEVEL);
+		glGenerateMipmap(GL_TEXTURE_2D);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		m_pages.push_back(page);
+	}
+
+	bool TextureAtlas::insert(Page& page, int width, int height, int& x, int& y){
+		int bestIndex = -1;
+		int bestBottom = PAGE_SIZE + 1;
+		int bestWidth = PAGE_SIZE + 1;
+
+		for (size_t i = 0; i < page.skyline.size(); i++)
+		{
+			int nodeY = fit(page, i, width, height);
+			if (nodeY < 0)
+			{
+				continue;
+			}
+			if (nodeY + height < bestBottom || (nodeY + height == bestBottom && page.skyline[i].width < bestWidth))
+			{
+				bestIndex = i;
+				bestBottom = nodeY + height;
+				bestWidth = page.skyline[i].width;
+				x = page.skyline[i].x;
+				y = nodeY;
+			}
+		}
+
+		if (bestIndex == -1)
+		{
+			return false;
+		}
+
+		//The new node covers the rectangle, the nodes under it shrink or go away
+		std::vector<SkylineNode>& skyline = page.skyline;
+		skyline.insert(skyline.begin() + bestIndex, { x, y + height, width });
+		for (size_t i = bestIndex + 1; i < skyline.size();)
+		{
+			int overlap = skyline[i - 1].x + skyline[i - 1].width - skyline[i].x;
+			if (overlap <= 0)
+			{
+				break;
+			}
+			skyline[i].x += overlap;
+			skyline[i].width -= overlap;
+			if (skyline[i].width <= 0)
+			{
+				skyline.erase(skyline.begin() + i);
+			}
+			else
+			{
+				break;
+			}
+		}
+
+		//Merge neighbours of the same height
+		for (size_t i = 0; i + 1 < skyline.size();)
+		{
+			if (skyline[i].y == skyline[i + 1].y)
+			{
+				skyline[i].width += skyline[i + 1].width;
+				skyline.erase(skyline.begin() + i + 1);
+			}
+			else
+			{
+				i++;
+			}
+		}
+
+		return true;
+	}
+
+	int TextureAtlas::fit(const Page& page, int index, int width, int height) const {
+		int x = page.skyline[index].x;
+		if (x + width > PAGE_SIZE)
+		{
+			return -1;
+		}
+
+		int y = 0;
+		int widthLeft = width;
+		for (size_t i = index; widthLeft > 0; i++)
+		{
+			y = std::max(y, page.skyline[i].y);
+			if (y + height > PAGE_SIZE)
+			{
+				return -1;
+			}
+			widthLeft -= page.skyline[i].width;
+		}
+		return y;
+	}
+
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "GLTexture.h"
+#include "ImageLoader.h"
+
+#include <vector>
+
+namespace GameEngine{
+
+	/// Where an image lives in a TextureAtlas, in pixels of its page
+	struct AtlasRegion{
+		int page = 0;
+		int x = 0;
+		int y = 0;
+		int width = 0;
+		int height = 0;
+	};
+
+	/// Packs small images into a few big GL textures (pages) with a skyline packer, so sprites with
+	/// different images still end up in one SpriteBatch render batch.
+	/// Every image gets its border repeated a few pixels outward, so filtering and the first mip levels
+	/// don't bleed the neighbours in. The images can't repeat (GL_REPEAT) though
+	class TextureAtlas
+	{
+	public:
+		TextureAtlas();
+		~TextureAtlas();
+
+		/// Deletes the pages, needs the GL context
+		void dispose();
+
+		/// Finds room for an image of this size, creating a page if needed. False if it is too big for a page
+		bool reserve(int width, int height, AtlasRegion& region);
+
+		/// Copies the image into its region and rebuilds the mip levels of the page
+		void upload(const AtlasRegion& region, const Image& image);
+
+		/// Page texture with the uv rect of the region
+		GLTexture getTexture(const AtlasRegion& region) const;
+
+		int getNumPages() const { return m_pages.size(); }
+
+	private:
+		/// Top edge of the used area from x to x + width
+		struct SkylineNode{
+			int x;
+			int y;
+			int width;
+		};
+
+		struct Page{
+			GLuint id = 0;
+			std::vector<SkylineNode> skyline;
+		};
+
+		void addPage();
+		/// Bottom left: lowest top edge first, then the narrowest node
+		bool insert(Page& page, int width, int height, int& x, int& y);
+		/// y the rectangle would have on node index, -1 if it sticks out of the page
+		int fit(const Page& page, int index, int width, int height) const;
+
+		std::vector<Page> m_pages;
+		std::vector<unsigned char> m_uploadBuffer; ///< Image plus border, reused between uploads
+	};
+
+}
@@ -1,10 +1,14 @@
 #include "TextureCache.h"
-#include "ImageLoader.h"
-#include <iostream>
+#include "GameEngineErrors.h"
+#include "Profiler.h"
+#include <chrono>
+#include <algorithm>
 
 
 namespace GameEngine{
 
+	const int NUM_LOADERS = 2; ///< Loader threads, file reads and PNG decoding are mostly independent
+
 	TextureCache::TextureCache(void)
 		{
 		}
@@ -12,32 +16,244 @@ namespace GameEngine{
 
 	TextureCache::~TextureCache(void)
 		{
+		//No GL calls here, the context may be gone already
+		stopLoaders();
 		}
 
 
 	GLTexture TextureCache::getTexture(std::string texturePath){
 		//lookup the texture and see if its in the map
-		//std::map<std::string, GLTexture>::iterator mit = m_textureMap.find(texturePath); 
-		//same as
 		auto mit = m_textureMap.find(texturePath);
 
 		//check if its not in the  map
 		if (mit == m_textureMap.end()){
 			//load the texture
-			GLTexture newTexture = ImageLoader::loadPNG(texturePath);
+			Entry& entry = m_textureMap[texturePath];
+			entry.texture = ImageLoader::loadPNG(texturePath);
+			return entry.texture;
+			}
+
+		if (mit->second.state != LoadState::UPLOADED){
+			finish(texturePath, mit->second);
+			}
+
+		return mit->second.texture;
+		}
+
+	GLTexture TextureCache::getTextureAsync(const std::string& texturePath){
+		auto mit = m_textureMap.find(texturePath);
+		if (mit != m_textureMap.end()){
+			return mit->second.texture;
+			}
+
+		Entry& entry = m_textureMap[texturePath];
+		glGenTextures(1, &(entry.texture.id));
+		ImageLoader::uploadPlaceholder(entry.texture.id);
+		entry.texture.uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+		queue(texturePath, entry);
+
+		return entry.texture;
+		}
+
+	GLTexture TextureCache::getAtlasTexture(const std::string& texturePath){
+		GLTexture texture = getAtlasTextureAsync(texturePath);
+
+		auto mit = m_atlasMap.find(texturePath);
+		if (mit == m_atlasMap.end()){
+			//Too big for the atlas
+			return getTexture(texturePath);
+			}
+
+		if (mit->second.state != LoadState::UPLOADED){
+			finish(texturePath, mit->second);
+			}
+		return texture;
+		}
+
+	GLTexture TextureCache::getAtlasTextureAsync(const std::string& texturePath){
+		auto mit = m_atlasMap.find(texturePath);
+		if (mit != m_atlasMap.end()){
+			return mit->second.texture;
+			}
+
+		AtlasRegion region;
+		int width, height;
+		if (!ImageLoader::readPNGSize(texturePath, width, height) || !m_atlas.reserve(width, height, region)){
+			//A missing file is reported by the normal path
+			return getTextureAsync(texturePath);
+			}
+
+		Entry& entry = m_atlasMap[texturePath];
+		entry.inAtlas = true;
+		entry.region = region;
+		entry.texture = m_atlas.getTexture(region);
+		queue(texturePath, entry);
+
+		return entry.texture;
+		}
+
+	void TextureCache::processUploads(float maxMilliseconds){
+		PROFILE_ZONE("TextureCache::processUploads");
 
-			//Insert it into the map
-			//std::pair<std::string, GLTexture> newPair(texturePath, newTexture);
-			//m_textureMap.insert(newPair);
-			//same as
-			m_textureMap.insert(make_pair(texturePath, newTexture));
+		auto start = std::chrono::steady_clock::now();
 
-			//std::cout << "Loaded Texture!\n";
-			return newTexture;
+		while (true)
+		{
+			Entry* entry = nullptr;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				//getTexture may have finished some of them already
+				while (!m_uploadQueue.empty() && m_uploadQueue.front()->state == LoadState::UPLOADED)
+				{
+					m_uploadQueue.pop_front();
+				}
+				if (m_uploadQueue.empty())
+				{
+					return;
+				}
+				entry = m_uploadQueue.front();
+				m_uploadQueue.pop_front();
 			}
 
-		//std::cout << "Used Cached Texture!\n";
-		return mit->second;
+			upload(*entry);
+
+			std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+			if (elapsed.count() >= maxMilliseconds)
+			{
+				return;
+			}
+		}
+		}
+
+	bool TextureCache::isLoading(){
+		std::lock_guard<std::mutex> lock(m_mutex);
+		return m_numLoading > 0;
+		}
+
+	void TextureCache::finish(const std::string& texturePath, Entry& entry){
+		std::unique_lock<std::mutex> lock(m_mutex);
+
+		if (entry.state == LoadState::QUEUED)
+		{
+			//Nobody started it yet, cheaper to decode it here than to wait for the queue
+			auto it = std::find_if(m_decodeQueue.begin(), m_decodeQueue.end(), [&](const std::pair<std::string, Entry*>& item){ return item.second == &entry; });
+			m_decodeQueue.erase(it);
+			entry.state = LoadState::DECODING;
+			lock.unlock();
+
+			decode(texturePath, entry);
+
+			lock.lock();
+			entry.state = LoadState::DECODED;
+		}
+		else
+		{
+			m_decoded.wait(lock, [&]{ return entry.state != LoadState::DECODING; });
+		}
+		lock.unlock();
+
+		//Still in the upload queue if a loader decoded it, processUploads skips it then
+		upload(entry);
+		}
+
+	void TextureCache::upload(Entry& entry){
+		if (entry.failed)
+		{
+			fatalError(entry.errorMessage);
+		}
+
+		if (entry.inAtlas)
+		{
+			if (entry.image.width != (unsigned long)entry.region.width || entry.image.height != (unsigned long)entry.region.height)
+			{
+				fatalError("Texture changed its size while loading!");
+			}
+			m_atlas.upload(entry.region, entry.image);
+		}
+		else
+		{
+			entry.texture = ImageLoader::uploadTexture(entry.texture.id, entry.image);
+		}
+		entry.image = Image();
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		entry.state = LoadState::UPLOADED;
+		m_numLoading--;
+		}
+
+	void TextureCache::decode(const std::string& texturePath, Entry& entry){
+		PROFILE_ZONE("TextureCache::decode");
+
+		//Errors are reported on the main thread, fatalError quits the program
+		entry.failed = !ImageLoader::readPNG(texturePath, entry.image, entry.errorMessage);
+		}
+
+	void TextureCache::queue(const std::string& texturePath, Entry& entry){
+		entry.state = LoadState::QUEUED;
+
+		if (m_loaders.empty()){
+			startLoaders();
+			}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_decodeQueue.emplace_back(texturePath, &entry);
+			m_numLoading++;
+		}
+		m_wakeUp.notify_one();
+		}
+
+	void TextureCache::startLoaders(){
+		m_quit = false;
+		for (int i = 0; i < NUM_LOADERS; i++)
+		{
+			m_loaders.emplace_back(&TextureCache::loaderLoop, this);
+		}
+		}
+
+	void TextureCache::stopLoaders(){
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_quit = true;
+		}
+		m_wakeUp.notify_all();
+
+		for (auto& loader : m_loaders)
+		{
+			loader.join();
+		}
+		m_loaders.clear();
+		}
+
+	void TextureCache::loaderLoop(){
+		Profiler::setThreadName("Texture loader");
+
+		while (true)
+		{
+			std::string texturePath;
+			Entry* entry = nullptr;
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_wakeUp.wait(lock, [this]{ return m_quit || !m_decodeQueue.empty(); });
+				if (m_quit)
+				{
+					return;
+				}
+				texturePath = std::move(m_decodeQueue.front().first);
+				entry = m_decodeQueue.front().second;
+				m_decodeQueue.pop_front();
+				entry->state = LoadState::DECODING;
+			}
+
+			decode(texturePath, *entry);
+
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				entry->state = LoadState::DECODED;
+				m_uploadQueue.push_back(entry);
+			}
+			m_decoded.notify_all();
+		}
 		}
 
-	}
\ No newline at end of file
+	}
@@ -1,19 +1,90 @@
 #pragma once
 #include <map>
+#include <deque>
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "GLTexture.h"
+#include "ImageLoader.h"
+#include "TextureAtlas.h"
 
 namespace GameEngine{
 
+	/// Loads every texture once.
+	/// getTextureAsync hands out the texture id at once, a few loader threads read and decode the file
+	/// and processUploads later puts the pixels into that same id on the main thread. Until then the
+	/// id shows a transparent placeholder, so code that only keeps the id never notices the difference
 	class TextureCache
 		{
 		public:
 			TextureCache(void);
 			~TextureCache(void);
 
+			/// Returns the finished texture, a texture that is still loading is finished right away
 			GLTexture getTexture(std::string texturePath);
 
-		private: 
-			std::map<std::string, GLTexture> m_textureMap;
+			/// Returns at once. width and height stay 0 until the texture is uploaded
+			GLTexture getTextureAsync(const std::string& texturePath);
+
+			/// Like getTexture, but the image is packed into a shared atlas page, so it draws in the same
+			/// batch as the other atlas textures. Uvs have to go through GLTexture::mapUVs and the
+			/// image can't repeat. An image too big for a page becomes a texture of its own
+			GLTexture getAtlasTexture(const std::string& texturePath);
+
+			/// getAtlasTexture without waiting, the region is reserved right away from the PNG header
+			/// and stays transparent until the pixels are uploaded
+			GLTexture getAtlasTextureAsync(const std::string& texturePath);
+
+			/// Uploads decoded textures until maxMilliseconds are used up, at least one per call.
+			/// Call it once per frame on the thread with the GL context
+			void processUploads(float maxMilliseconds);
+
+			/// True while any texture is queued, decoding or waiting for its upload
+			bool isLoading();
+
+		private:
+			enum class LoadState{
+				QUEUED,
+				DECODING,
+				DECODED,
+				UPLOADED
+			};
+
+			struct Entry{
+				GLTexture texture = {};
+				LoadState state = LoadState::UPLOADED;
+				bool failed = false;
+				bool inAtlas = false;
+				AtlasRegion region; ///< Where the pixels go when inAtlas
+				Image image; ///< Decoded pixels until the upload
+				std::string errorMessage;
+			};
+
+			/// Decodes a queued entry on the calling thread or waits for the loader that has it, then uploads it
+			void finish(const std::string& texturePath, Entry& entry);
+			void upload(Entry& entry);
+			void decode(const std::string& texturePath, Entry& entry);
+			void queue(const std::string& texturePath, Entry& entry);
+
+			void startLoaders();
+			void stopLoaders();
+			void loaderLoop();
+
+			std::map<std::string, Entry> m_textureMap; ///< Only changed on the main thread, entries never move
+			std::map<std::string, Entry> m_atlasMap; ///< The same for the atlas textures
+
+			TextureAtlas m_atlas;
+
+			std::vector<std::thread> m_loaders;
+			std::mutex m_mutex; ///< Guards the queues and the state of the entries
+			std::condition_variable m_wakeUp; ///< Loaders wait for work or for quitting
+			std::condition_variable m_decoded; ///< finish waits for a loader
+			std::deque<std::pair<std::string, Entry*>> m_decodeQueue;
+			std::deque<Entry*> m_uploadQueue;
+			int m_numLoading = 0;
+			bool m_quit = false;
 		};
 
 	}
@@ -0,0 +1,246 @@
+#include "TextureDiskCache.h"
+#include "ImageLoader.h"
+#include "IOManager.h"
+#include "AssetPack.h"
+
+#include <sys/stat.h>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+
+#ifdef _WIN32
+#include <direct.h>
+#endif
+
+namespace GameEngine{
+
+	const char CACHE_MAGIC[4] = { 'G', 'E', 'T', 'X' };
+	const uint32_t CACHE_VERSION = 1;
+
+	/// Start of every cache file, the RGBA8 pixels of all levels follow right after it
+	struct CacheHeader{
+		char magic[4];
+		uint32_t version;
+		uint64_t sourceSize;
+		int64_t sourceTime; ///< Modification time of the PNG
+		uint64_t sourceHash; ///< Of the PNG bytes, checked when the time doesn't match
+		uint32_t width;
+		uint32_t height;
+		uint32_t numLevels;
+		uint32_t reserved;
+	};
+
+	std::string TextureDiskCache::m_directory = "Cache/Textures/";
+
+	static bool getSourceStamp(const std::string& pngPath, uint64_t& size, int64_t& time){
+		//A packed PNG has no time of its own, the content hash from the pack stands in for it
+		const PackEntry* entry = IOManager::findPacked(pngPath);
+		if (entry != nullptr)
+		{
+			size = entry->originalSize;
+			time = (int64_t)entry->contentHash;
+			return true;
+		}
+
+		struct stat info;
+		if (stat(pngPath.c_str(), &info) != 0)
+		{
+			return false;
+		}
+		size = (uint64_t)info.st_size;
+		time = (int64_t)info.st_mtime;
+		return true;
+	}
+
+	static size_t getLevelsSize(uint32_t width, uint32_t height, uint32_t numLevels){
+		size_t size = 0;
+		for (uint32_t level = 0; level < numLevels; level++)
+		{
+			size += (size_t)std::max(width >> level, 1u) * std::max(height >> level, 1u) * 4;
+		}
+		return size;
+	}
+
+	static void makeDirectories(const std::string& path){
+		for (size_t i = 1; i < path.size(); i++)
+		{
+			if (path[i] == '/' || path[i] == '\\')
+			{
+				std::string directory = path.substr(0, i);
+#ifdef _WIN32
+				_mkdir(directory.c_str());
+#else
+				mkdir(directory.c_str(), 0755);
+#endif
+			}
+		}
+	}
+
+	/// Halves the level with a 2x2 box filter, an odd last row or column is averaged with itself
+	static void downsample(const unsigned char* source, uint32_t width, uint32_t height, unsigned char* destination){
+		uint32_t newWidth = std::max(width >> 1, 1u);
+		uint32_t newHeight = std::max(height >> 1, 1u);
+
+		for (uint32_t y = 0; y < newHeight; y++)
+		{
+			uint32_t y0 = std::min(y * 2, height - 1);
+			uint32_t y1 = std::min(y * 2 + 1, height - 1);
+			for (uint32_t x = 0; x < newWidth; x++)
+			{
+				uint32_t x0 = std::min(x * 2, width - 1);
+				uint32_t x1 = std::min(x * 2 + 1, width - 1);
+				for (int c = 0; c < 4; c++)
+				{
+					int sum = source[(y0 * width + x0) * 4 + c] + source[(y0 * width + x1) * 4 + c] +
+						source[(y1 * width + x0) * 4 + c] + source[(y1 * width + x1) * 4 + c];
+					destination[(y * newWidth + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+				}
+			}
+		}
+	}
+
+	bool TextureDiskCache::load(const std::string& pngPath, Image& image){
+		if (m_directory.empty())
+		{
+			return false;
+		}
+
+		auto file = std::make_shared<FileView>();
+		if (!file->open(getCachePath(pngPath)) || file->size() < sizeof(CacheHeader))
+		{
+			return false;
+		}
+
+		CacheHeader header;
+		std::memcpy(&header, file->data(), sizeof(header));
+		if (std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) != 0 || header.version != CACHE_VERSION ||
+			file->size() != sizeof(CacheHeader) + getLevelsSize(header.width, header.height, header.numLevels))
+		{
+			return false;
+		}
+
+		//Same size and time is good enough, otherwise the content decides (a fresh checkout touches every file)
+		uint64_t sourceSize;
+		int64_t sourceTime;
+		if (!getSourceStamp(pngPath, sourceSize, sourceTime) || sourceSize != header.sourceSize)
+		{
+			return false;
+		}
+		if (sourceTime != header.sourceTime && hashFile(pngPath) != header.sourceHash)
+		{
+			return false;
+		}
+
+		image.pixels.clear();
+		image.data = file->data() + sizeof(CacheHeader);
+		image.storage = file;
+		image.width = header.width;
+		image.height = header.height;
+		image.numLevels = header.numLevels;
+		return true;
+	}
+
+	bool TextureDiskCache::store(const std::string& pngPath, const unsigned char* png, size_t pngSize, Image& image){
+		//Build the whole mip chain down to 1x1 behind the full image
+		uint32_t width = image.width;
+		uint32_t height = image.height;
+		uint32_t numLevels = 1;
+		while ((width >> (numLevels - 1)) > 1 || (height >> (numLevels - 1)) > 1)
+		{
+			numLevels++;
+		}
+
+		image.pixels.resize(getLevelsSize(width, height, numLevels));
+		unsigned char* level = image.pixels.data();
+		for (uint32_t i = 1; i < numLevels; i++)
+		{
+			uint32_t levelWidth = std::max(width >> (i - 1), 1u);
+			uint32_t levelHeight = std::max(height >> (i - 1), 1u);
+			unsigned char* next = level + (size_t)levelWidth * levelHeight * 4;
+			downsample(level, levelWidth, levelHeight, next);
+			level = next;
+		}
+		image.data = image.pixels.data();
+		image.numLevels = numLevels;
+
+		if (m_directory.empty())
+		{
+			return false;
+		}
+
+		CacheHeader header = {};
+		std::memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+		header.version = CACHE_VERSION;
+		if (!getSourceStamp(pngPath, header.sourceSize, header.sourceTime))
+		{
+			return false;
+		}
+		header.sourceHash = hash(png, pngSize);
+		header.width = width;
+		header.height = height;
+		header.numLevels = numLevels;
+
+		//Written under another name first, so a crash never leaves half a cache file behind
+		std::string cachePath = getCachePath(pngPath);
+		std::string tempPath = cachePath + ".tmp";
+		makeDirectories(cachePath);
+
+		FILE* file = fopen(tempPath.c_str(), "wb");
+		if (file == nullptr)
+		{
+			return false;
+		}
+		bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+			fwrite(image.pixels.data(), image.pixels.size(), 1, file) == 1;
+		written = fclose(file) == 0 && written;
+
+		std::remove(cachePath.c_str());
+		if (!written || std::rename(tempPath.c_str(), cachePath.c_str()) != 0)
+		{
+			std::remove(tempPath.c_str());
+			return false;
+		}
+		return true;
+	}
+
+	uint64_t TextureDiskCache::hash(const unsigned char* data, size_t size, uint64_t hash /* = FNV_OFFSET_BASIS */){
+		for (size_t i = 0; i < size; i++)
+		{
+			hash ^= data[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+
+	uint64_t TextureDiskCache::hashFile(const std::string& filePath){
+		FileReader file;
+		if (!file.open(filePath))
+		{
+			return 0;
+		}
+
+		unsigned char buffer[16384];
+		uint64_t result = FNV_OFFSET_BASIS;
+		size_t size;
+		while ((size = file.read(buffer, sizeof(buffer))) > 0)
+		{
+			result = hash(buffer, size, result);
+		}
+		return result;
+	}
+
+	std::string TextureDiskCache::getCachePath(const std::string& pngPath){
+		//One flat directory, the path of the PNG becomes the file name
+		std::string name = pngPath;
+		for (auto& c : name)
+		{
+			if (c == '/' || c == '\\' || c == ':')
+			{
+				c = '_';
+			}
+		}
+		return m_directory + name + ".tex";
+	}
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+
+namespace GameEngine{
+
+	struct Image;
+
+	/// Keeps the decoded pixels of every PNG in a file of its own, together with all mip levels and
+	/// the size, time and hash of the PNG they came from. Loading such a file is one memory mapping,
+	/// no inflate and no glGenerateMipmap. A cache file whose PNG changed is rebuilt
+	class TextureDiskCache
+	{
+	public:
+		/// Where the cache files go, an empty string turns the cache off
+		static void setDirectory(const std::string& directory) { m_directory = directory; }
+		static const std::string& getDirectory() { return m_directory; }
+
+		/// Maps the cache file of the PNG into image, fails if there is none or the PNG changed since
+		static bool load(const std::string& pngPath, Image& image);
+
+		/// Builds the mip levels of the decoded image and writes them into the cache file of the PNG.
+		/// png is the file content, used for the hash
+		static bool store(const std::string& pngPath, const unsigned char* png, size_t pngSize, Image& image);
+
+		static const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+
+		/// FNV-1a, continues from hash
+		static uint64_t hash(const unsigned char* data, size_t size, uint64_t hash = FNV_OFFSET_BASIS);
+		/// hash of a whole file, read piece by piece
+		static uint64_t hashFile(const std::string& filePath);
+
+	private:
+		static std::string getCachePath(const std::string& pngPath);
+
+		static std::string m_directory;
+	};
+
+}
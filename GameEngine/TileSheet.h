@@ -23,7 +23,8 @@ namespace GameEngine{
 			uvs.z = 1.0f / dims.x;
 			uvs.w = 1.0f / dims.y;
 
-			return uvs;
+			//The sheet may be a part of an atlas page
+			return texture.mapUVs(uvs);
 		}
 
 		GLTexture texture;
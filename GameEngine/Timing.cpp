@@ -1,75 +1,122 @@
 #include "Timing.h"
 #include <SDL/SDL.h>
 
+#include <algorithm>
+#include <cmath>
 
 namespace GameEngine{
 
-	FpsLimiter::FpsLimiter(){
-		}
+	const int NUM_SAMPLES = 120; ///< Frames the fps and the frame time stats are taken over
+	const double SPIN_MILLISECONDS = 2.0; ///< The last part of a frame is busy waited instead of slept
+
+	FpsLimiter::FpsLimiter() :
+		m_counterFrequency((double)SDL_GetPerformanceFrequency()),
+		m_frameTimes(NUM_SAMPLES, 0.0f)
+	{
+	}
 
 	void FpsLimiter::init(float maxFPS){
 		setMaxFPS(maxFPS);
-		}
+	}
 
 	void FpsLimiter::setMaxFPS(float maxFPS){
 		m_maxFPS = maxFPS;
-		}
+	}
 
 	void FpsLimiter::beginFrame(){
-		m_startTicks = SDL_GetTicks();
-
-		}
+		m_startCounter = SDL_GetPerformanceCounter();
+	}
 
 	float FpsLimiter::end(){
 		calculateFPS();
 
-		float frameTicks = SDL_GetTicks() - m_startTicks;
-		//Limit the FPS to the max FPS value 
-		if (1000.0f / m_maxFPS > frameTicks){
-			SDL_Delay(1000.0f / m_maxFPS - frameTicks);
-			}
+		//Limit the FPS to the max FPS value, 0 = no limit
+		if (m_maxFPS > 0.0f)
+		{
+			waitUntil(m_startCounter + (uint64_t)(m_counterFrequency / m_maxFPS));
+		}
 
 		return m_fps;
-		}
+	}
 
+	FrameTimeStats FpsLimiter::getFrameTimeStats() const {
+		FrameTimeStats stats;
 
-	void FpsLimiter::calculateFPS(){
-		static const int NUM_SAMPLES = 10;
-		static float frameTimes[NUM_SAMPLES];
-		static int currentFrame = 0;
+		int count = std::min(m_numFrames, NUM_SAMPLES);
+		if (count == 0)
+		{
+			return stats;
+		}
 
-		static float prevTicks = SDL_GetTicks();
+		std::vector<float> sorted(m_frameTimes.begin(), m_frameTimes.begin() + count);
+		std::sort(sorted.begin(), sorted.end());
 
-		float currentTicks;
-		currentTicks = SDL_GetTicks();
+		float sum = 0.0f;
+		for (float frameTime : sorted)
+		{
+			sum += frameTime;
+		}
+		stats.average = sum / count;
 
-		m_frameTime = currentTicks - prevTicks;
-		frameTimes[currentFrame % NUM_SAMPLES] = m_frameTime;
+		//Nearest rank, p99 over 120 frames is the second slowest one
+		auto percentile = [&](float p){
+			int rank = (int)std::ceil(p * count) - 1;
+			return sorted[std::min(std::max(rank, 0), count - 1)];
+		};
+		stats.p50 = percentile(0.50f);
+		stats.p95 = percentile(0.95f);
+		stats.p99 = percentile(0.99f);
+		stats.max = sorted.back();
 
-		prevTicks = currentTicks;
+		return stats;
+	}
 
-		int count; 
+	void FpsLimiter::calculateFPS(){
+		uint64_t counter = SDL_GetPerformanceCounter();
+
+		//The first frame has nothing to measure against
+		if (m_previousCounter != 0)
+		{
+			m_frameTime = (float)((counter - m_previousCounter) * 1000.0 / m_counterFrequency);
+			m_frameTimes[m_numFrames % NUM_SAMPLES] = m_frameTime;
+			m_numFrames++;
+		}
+		m_previousCounter = counter;
 
-		currentFrame++;
-		if (currentFrame < NUM_SAMPLES){
-			count = currentFrame;
-			} else {
-				count = NUM_SAMPLES;
-			}
+		int count = std::min(m_numFrames, NUM_SAMPLES);
 
-		float frameTimeAverage = 0;
+		float frameTimeAverage = 0.0f;
 		for (int i = 0; i < count; i++)
+		{
+			frameTimeAverage += m_frameTimes[i];
+		}
+
+		if (count > 0 && frameTimeAverage > 0.0f)
+		{
+			m_fps = 1000.0f * count / frameTimeAverage;
+		}
+		else
+		{
+			m_fps = 60.0f;
+		}
+	}
+
+	void FpsLimiter::waitUntil(uint64_t deadline) const {
+		while (true)
+		{
+			uint64_t counter = SDL_GetPerformanceCounter();
+			if (counter >= deadline)
 			{
-			frameTimeAverage += frameTimes[i];
+				return;
 			}
-		frameTimeAverage /= count;
 
-		if (frameTimeAverage > 0){
-			m_fps = 1000.0f / frameTimeAverage;
-			} else {
-				m_fps =  60.0f;
+			double remaining = (deadline - counter) * 1000.0 / m_counterFrequency;
+			if (remaining > SPIN_MILLISECONDS)
+			{
+				//SDL_Delay may wake up a millisecond or more late, so leave the rest for the spin
+				SDL_Delay((Uint32)(remaining - SPIN_MILLISECONDS));
 			}
-
 		}
+	}
 
-	}
\ No newline at end of file
+}
@@ -1,13 +1,27 @@
 #pragma once
 
+#include <vector>
+#include <cstdint>
 
 namespace GameEngine{
 
+	/// Frame times in milliseconds over the last frames
+	struct FrameTimeStats{
+		float average = 0.0f;
+		float p50 = 0.0f;
+		float p95 = 0.0f;
+		float p99 = 0.0f;
+		float max = 0.0f;
+	};
+
+	/// Measures the frames with the performance counter and waits for the end of a frame to limit the fps.
+	/// Every limiter keeps its own samples, so several of them don't mix their frame times
 	class FpsLimiter{
 	public:
 		FpsLimiter();
 		void init(float maxFPS);
 
+		/// 0 = no limit
 		void setMaxFPS(float maxFPS);
 
 		void beginFrame();
@@ -15,14 +29,26 @@ namespace GameEngine{
 		//end will return the current FPS
 		float end();
 
+		/// Time between the last two calls of end in milliseconds
+		float getFrameTime() const { return m_frameTime; }
+
+		/// Average and percentiles of the frame times the fps are taken over
+		FrameTimeStats getFrameTimeStats() const;
+
 	private:
 		void calculateFPS();
 
-		float m_fps;
-		float m_maxFPS;
-		float m_frameTime;
-		unsigned int m_startTicks;
-		};
+		/// Sleeps until shortly before the deadline and spins the rest, SDL_Delay alone oversleeps
+		void waitUntil(uint64_t deadline) const;
 
+		float m_fps = 0.0f;
+		float m_maxFPS = 0.0f;
+		float m_frameTime = 0.0f;
+		double m_counterFrequency = 1.0; ///< Performance counter ticks per second
+		uint64_t m_startCounter = 0;
+		uint64_t m_previousCounter = 0; ///< Counter at the last end, 0 = no frame yet
+		std::vector<float> m_frameTimes; ///< Ring buffer of the last frame times in milliseconds
+		int m_numFrames = 0;
+	};
 
-	}
\ No newline at end of file
+}
@@ -98,20 +98,21 @@ void GameplayScreen::onEntry() {
 
 void GameplayScreen::onExit() {
 	m_debugRenderer.dispose();
+	m_spriteBatch.dispose();
 }
 
 
-void GameplayScreen::update() {
+void GameplayScreen::update(float deltaTime) {
 	m_camera.update();
 	checkInput();
 
 	m_player.update(m_game->inputManager);
 
-	//Update the physics simulation
-	m_world->Step(1.0f / 60.0f, 6, 2);
+	//Update the physics simulation, deltaTime counts ticks at BASE_TICK_RATE
+	m_world->Step(deltaTime / GameEngine::BASE_TICK_RATE, 6, 2);
 }
 
-void GameplayScreen::draw() {
+void GameplayScreen::draw(float alpha) {
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
 
@@ -26,8 +26,8 @@ public:
 	virtual void onEntry() override;
 	virtual void onExit() override;
 
-	virtual void update() override;
-	virtual void draw() override;
+	virtual void update(float deltaTime) override;
+	virtual void draw(float alpha) override;
 
 private:
 	void checkInput();
@@ -1,7 +1,11 @@
 #include <GameEngine\IMainGame.h>
+#include <GameEngine\IOManager.h>
 #include "App.h"
 
 int main(int argc, char** argv) {
+	//Release builds ship their assets in one pack, without it the loose files are used
+	GameEngine::IOManager::mountPack("Assets.pak");
+
 	App app;
 	app.run();
 	
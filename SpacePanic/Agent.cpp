@@ -13,9 +13,9 @@ Agent::~Agent(){
 
 }
 
-void Agent::draw(GameEngine::SpriteBatch& spriteBatch){
+void Agent::draw(GameEngine::SpriteBatch& spriteBatch, float alpha){
 
-	glm::vec2 position = m_collisionBox.getPosition();
+	glm::vec2 position = getDrawPosition(alpha);
 
 	glm::vec4 destRect(position.x, position.y, AGENT_WIDTH, AGENT_WIDTH);
 
@@ -72,12 +72,29 @@ bool Agent::collideWithLevel(std::vector<Box>& levelBoxes){
 
 }
 
+bool Agent::collideWithLevel(BoxGrid& levelBoxes){
+
+	bool collided = false;
+
+	for (int index : levelBoxes.query(m_collisionBox.m_position, m_collisionBox.m_dimensions)){
+		glm::vec4 penetrationDepth;
+		if (collideWithBox(&levelBoxes[index], penetrationDepth)){
+			handleCollisionWithUnmoveableObject(penetrationDepth);
+
+			collided = true;
+		}
+	}
+
+	return collided;
+}
+
 
-bool Agent::collideWithLadder(std::vector<Box>& ladderBoxes){
+bool Agent::collideWithLadder(BoxGrid& ladderBoxes){
 
 	bool collided = false;
 
-	for (auto& box : ladderBoxes){
+	for (int index : ladderBoxes.query(m_collisionBox.m_position, m_collisionBox.m_dimensions)){
+		Box& box = ladderBoxes[index];
 		glm::vec4 penetrationDepth;
 		if (collideWithBox(&box, penetrationDepth)){
 			float xDepth = abs(penetrationDepth.z - penetrationDepth.x);
@@ -90,11 +107,11 @@ bool Agent::collideWithLadder(std::vector<Box>& ladderBoxes){
 	return collided;
 }
 
-bool Agent::collideBoxWithBoxes(Box& box, std::vector<Box>& otherBoxes){
+bool Agent::collideBoxWithBoxes(Box& box, BoxGrid& otherBoxes){
 	bool collided = false;
 
-	for (auto& otherBox : otherBoxes){
-		if (collideBoxWithBox(box, otherBox)){
+	for (int index : otherBoxes.query(box.m_position, box.m_dimensions)){
+		if (collideBoxWithBox(box, otherBoxes[index])){
 			collided = true;
 		}
 	}
@@ -102,9 +119,10 @@ bool Agent::collideBoxWithBoxes(Box& box, std::vector<Box>& otherBoxes){
 
 }
 
-Box* Agent::collideWithLadderAndGetLadderBox(std::vector<Box>& ladderBoxes){
+Box* Agent::collideWithLadderAndGetLadderBox(BoxGrid& ladderBoxes){
 
-	for (auto& box : ladderBoxes){
+	for (int index : ladderBoxes.query(m_collisionBox.m_position, m_collisionBox.m_dimensions)){
+		Box& box = ladderBoxes[index];
 		glm::vec4 penetrationDepth;
 		if (collideWithBox(&box, penetrationDepth)){
 
@@ -114,9 +132,10 @@ Box* Agent::collideWithLadderAndGetLadderBox(std::vector<Box>& ladderBoxes){
 	return nullptr;
 }
 
-glm::vec4 Agent::collideWithLadderAndGetCollisionDepth(std::vector<Box>& ladderBoxes){
+glm::vec4 Agent::collideWithLadderAndGetCollisionDepth(BoxGrid& ladderBoxes){
 
-	for (auto& box : ladderBoxes){
+	for (int index : ladderBoxes.query(m_collisionBox.m_position, m_collisionBox.m_dimensions)){
+		Box& box = ladderBoxes[index];
 		glm::vec4 penetrationDepth;
 		if (collideWithBox(&box, penetrationDepth)){
 			return penetrationDepth;
@@ -450,7 +469,7 @@ bool Agent::isSameBox(Box* box, Box* otherBox){
 	return (box->getPosition().x == otherBox->getPosition().x && box->getPosition().y == otherBox->getPosition().y && box->getDimensions().x == otherBox->getDimensions().x && box->getDimensions().y == otherBox->getDimensions().y);
 }
 
-bool Agent::isInAir(std::vector<Box>& levelBoxes){
+bool Agent::isInAir(BoxGrid& levelBoxes){
 	Box& groundBoxLeft = Box();
 	Box& groundBoxRight = Box();
 
@@ -485,13 +504,14 @@ bool Agent::isInAir(std::vector<Box>& levelBoxes){
 	}
 }
 
-bool Agent::canWalkForward(std::vector<Box>& levelBoxes, Box& groundBox, Box& boxAboveGround){
+bool Agent::canWalkForward(BoxGrid& levelBoxes, Box& groundBox, Box& boxAboveGround){
 	bool wallAboveGround = false;
 	bool foundGroundBox = false;
 
 	glm::vec4& penetrationDepth = glm::vec4();
 
-	for (size_t i = 0; i < levelBoxes.size(); i++)
+	//The box above the ground sits right on top of it, so one query covers both
+	for (int i : levelBoxes.query(groundBox.m_position, glm::vec2(groundBox.m_dimensions.x, groundBox.m_dimensions.y + boxAboveGround.m_dimensions.y)))
 	{
 		/*	Box boxAboveLevelGround = Box();
 		boxAboveLevelGround.m_dimensions = box.m_dimensions;
@@ -517,10 +537,10 @@ bool Agent::canWalkForward(std::vector<Box>& levelBoxes, Box& groundBox, Box& bo
 
 }
 
-bool Agent::halfHoleAhead(std::vector<Box>& halfHoleBoxes, Box& groundBox){
+bool Agent::halfHoleAhead(BoxGrid& halfHoleBoxes, Box& groundBox){
 	return collideBoxWithBoxes(groundBox, halfHoleBoxes);
 }
 
-bool Agent::holeAhead(std::vector<Box>& holeBoxes, Box& groundBox){
+bool Agent::holeAhead(BoxGrid& holeBoxes, Box& groundBox){
 	return collideBoxWithBoxes(groundBox, holeBoxes);
 }
\ No newline at end of file
@@ -6,6 +6,7 @@
 #include <GameEngine\SpriteBatch.h>
 
 #include "Box.h"
+#include "BoxGrid.h"
 
 const float AGENT_WIDTH = 60;
 const float AGENT_RADIUS = AGENT_WIDTH / 2.0f;
@@ -26,7 +27,8 @@ public:
 		{}
 		*/
 
-	void draw(GameEngine::SpriteBatch& spriteBatch);
+	//Draws the agent between its last two ticks, alpha = 0 is the previous tick
+	void draw(GameEngine::SpriteBatch& spriteBatch, float alpha = 1.0f);
 
 	virtual void update(const std::vector<std::string>& levelData,
 		std::vector<Player*>& players, std::vector<Monster*>& monsters, float deltaTime) = 0;
@@ -35,15 +37,22 @@ public:
 
 	virtual void update(Level& level, std::vector<Player*>& players, std::vector<Monster*>& monsters, float deltaTime) = 0;
 
-	virtual bool collideWithHalfHole(std::vector<Box>& levelBoxes) = 0;
-	virtual bool collideWithHole(std::vector<Box>& levelBoxes) = 0;
+	virtual bool collideWithHalfHole(BoxGrid& halfHoleBoxes) = 0;
+	virtual bool collideWithHole(BoxGrid& holeBoxes) = 0;
 
 	glm::vec2 getPosition() const { return m_collisionBox.getPosition(); }
+	//Position between the last two ticks, alpha = 0 is the previous tick
+	glm::vec2 getDrawPosition(float alpha) const { return glm::mix(m_previousPosition, m_collisionBox.getPosition(), alpha); }
+	//Call it at the start of every tick, the position becomes the start of the interpolation
+	//and the animation gets deltaTime more to play at the next draw
+	void beginTick(float deltaTime) { m_previousPosition = m_collisionBox.getPosition(); m_animFrames += deltaTime; }
 	void setPosition(glm::vec2 newPosition) { m_collisionBox.m_position = newPosition; }
 
 	bool collideWithLevel(const std::vector<std::string>& levelData);
 	bool collideWithLevel(std::vector<Box>& levelBoxes);
-	bool collideWithLadder(std::vector<Box>& ladderBoxes);
+	//Only checks the boxes around the agent
+	bool collideWithLevel(BoxGrid& levelBoxes);
+	bool collideWithLadder(BoxGrid& ladderBoxes);
 
 	bool collideWithAgent(Agent* agent, glm::vec4& penetrationDepth = glm::vec4());
 
@@ -80,19 +89,19 @@ protected:
 
 	bool collideBoxWithBox(const Box& box, const Box& otherBox);
 	bool collideBoxWithBox(const Box& box, const Box& otherBox, glm::vec4& penetrationDepth);
-	bool collideBoxWithBoxes(Box& box, std::vector<Box>& boxes);
+	bool collideBoxWithBoxes(Box& box, BoxGrid& boxes);
 
-	Box* collideWithLadderAndGetLadderBox(std::vector<Box>& ladderBoxes);
-	glm::vec4 collideWithLadderAndGetCollisionDepth(std::vector<Box>& ladderBoxes);
+	Box* collideWithLadderAndGetLadderBox(BoxGrid& ladderBoxes);
+	glm::vec4 collideWithLadderAndGetCollisionDepth(BoxGrid& ladderBoxes);
 
 	void handleCollisionWithUnmoveableObject(glm::vec4 penetrationDepth);
 
 	bool isSameBox(Box* box, Box* otherBox);
-	bool isInAir(std::vector<Box>& levelBoxes);
-	bool canWalkForward(std::vector<Box>& levelBoxes, Box& groundBox, Box& boxAboveGround);
+	bool isInAir(BoxGrid& levelBoxes);
+	bool canWalkForward(BoxGrid& levelBoxes, Box& groundBox, Box& boxAboveGround);
 
-	bool halfHoleAhead(std::vector<Box>& halfHoleBoxes, Box& groundBox);
-	bool holeAhead(std::vector<Box>& holeBoxes, Box& groundBox);
+	bool halfHoleAhead(BoxGrid& halfHoleBoxes, Box& groundBox);
+	bool holeAhead(BoxGrid& holeBoxes, Box& groundBox);
 
 	bool m_onLadder = false;
 
@@ -102,6 +111,8 @@ protected:
 	float m_health;
 
 	Box m_collisionBox;
+	glm::vec2 m_previousPosition = glm::vec2(0.0f); ///< Position before the current tick
+	float m_animFrames = 0.0f; ///< Ticks since the animation was last advanced, 1.0 at BASE_TICK_RATE
 
 
 
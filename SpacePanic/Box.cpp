@@ -23,7 +23,7 @@ void Box::init(
 	m_position = position;
 	m_dimensions = dimensions;
 	m_color = color;
-	m_uvRect = uvRect;
+	m_uvRect = texture->mapUVs(uvRect);
 	m_textureID = texture->id;
 
 	m_texture.init(*texture, glm::ivec2(10, 2));
@@ -39,13 +39,23 @@ void Box::init(
 	m_position = position;
 	m_dimensions = dimensions;
 	m_color = color;
-	m_uvRect = uvRect;
+	m_uvRect = texture->mapUVs(uvRect);
 	m_textureID = texture->id;
 
 	m_texture.init(*texture, tileDimns);
 }
 
+void Box::setTexture(const GameEngine::GLTexture& texture){
+	m_textureID = texture.id;
+	m_texture.texture = texture;
+	m_uvRect = texture.uvRect;
+}
+
 void Box::draw(GameEngine::SpriteBatch& spriteBatch){
+	spriteBatch.draw(getDestRect(), m_uvRect, m_textureID, 0.0f, m_color);
+}
+
+glm::vec4 Box::getDestRect() const{
 	glm::vec4 destRect;
 	if (m_drawDims == glm::vec2(0.0f, 0.0f))
 	{
@@ -61,7 +71,7 @@ void Box::draw(GameEngine::SpriteBatch& spriteBatch){
 		destRect.w = m_drawDims.y;
 	}
 
-	spriteBatch.draw(destRect, m_uvRect, m_textureID, 0.0f, m_color);
+	return destRect;
 }
 
 void Box::draw(GameEngine::SpriteBatch& spriteBatch, glm::vec4 destRect){
@@ -20,7 +20,7 @@ public:
 		const glm::vec2 dimensions,
 		GameEngine::GLTexture* texture,
 		GameEngine::ColorRGBA8 color,
-		glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
+		glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)); ///< Of the image, mapped into the atlas if the texture is in one
 
 	void init(
 		const glm::vec2 position,
@@ -30,9 +30,15 @@ public:
 		GameEngine::ColorRGBA8 color,
 		glm::vec4 uvRect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f));
 
+	/// Shows the whole texture from now on
+	void setTexture(const GameEngine::GLTexture& texture);
+
 	void draw(GameEngine::SpriteBatch& spriteBatch);
 	void draw(GameEngine::SpriteBatch& spriteBatch, glm::vec4 destRect);
 
+	//Rectangle the box is drawn into
+	glm::vec4 getDestRect() const;
+
 	void collideWithBox(Box box);
 
 	const glm::vec2& getPosition() const { return m_position; }
@@ -46,6 +52,7 @@ public:
 	glm::vec2 getDrawDims() const { return m_drawDims; }
 	void setDrawDims(glm::vec2 drawDims){ m_drawDims = drawDims; }
 
+	const glm::vec4& getUVRect() const { return m_uvRect; }
 	void setUVRect(glm::vec4 uvRect) { m_uvRect = uvRect; }
 
 private:
@@ -0,0 +1,108 @@
+#include "BoxGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+
+BoxGrid::BoxGrid()
+{
+}
+
+
+BoxGrid::~BoxGrid()
+{
+}
+
+void BoxGrid::init(int width, int height, float cellSize){
+	m_width = std::max(width, 1);
+	m_height = std::max(height, 1);
+	m_cellSize = cellSize;
+	clear();
+}
+
+void BoxGrid::clear(){
+	m_boxes.clear();
+	m_boxCells.clear();
+	m_nextInCell.clear();
+	m_cellHeads.assign(m_width * m_height, -1);
+}
+
+void BoxGrid::add(const Box& box){
+	int index = m_boxes.size();
+	int cell = getCell(box.getPosition());
+
+	m_boxes.push_back(box);
+	m_boxCells.push_back(cell);
+	m_nextInCell.push_back(m_cellHeads[cell]);
+	m_cellHeads[cell] = index;
+}
+
+void BoxGrid::remove(size_t index){
+	int last = m_boxes.size() - 1;
+
+	unlink(index);
+
+	if (index != last)
+	{
+		//The last box takes the free index, so the link pointing to it has to follow
+		unlink(last);
+
+		m_boxes[index] = m_boxes[last];
+		m_boxCells[index] = m_boxCells[last];
+		m_nextInCell[index] = m_cellHeads[m_boxCells[index]];
+		m_cellHeads[m_boxCells[index]] = index;
+	}
+
+	m_boxes.pop_back();
+	m_boxCells.pop_back();
+	m_nextInCell.pop_back();
+}
+
+const std::vector<int>& BoxGrid::query(glm::vec2 position, glm::vec2 dimensions){
+	m_queryResult.clear();
+
+	//Boxes are stored in the cell of their bottom left corner, so one more cell to the left and below
+	int minX = (int)std::floor(position.x / m_cellSize) - 2;
+	int minY = (int)std::floor(position.y / m_cellSize) - 2;
+	int maxX = (int)std::floor((position.x + dimensions.x) / m_cellSize) + 1;
+	int maxY = (int)std::floor((position.y + dimensions.y) / m_cellSize) + 1;
+	clampCell(minX, minY);
+	clampCell(maxX, maxY);
+
+	for (int y = minY; y <= maxY; y++)
+	{
+		for (int x = minX; x <= maxX; x++)
+		{
+			for (int index = m_cellHeads[y * m_width + x]; index != -1; index = m_nextInCell[index])
+			{
+				m_queryResult.push_back(index);
+			}
+		}
+	}
+
+	std::sort(m_queryResult.begin(), m_queryResult.end());
+
+	return m_queryResult;
+}
+
+int BoxGrid::getCell(glm::vec2 position) const {
+	int x = (int)std::floor(position.x / m_cellSize);
+	int y = (int)std::floor(position.y / m_cellSize);
+	clampCell(x, y);
+	return y * m_width + x;
+}
+
+void BoxGrid::clampCell(int& x, int& y) const {
+	//Boxes outside the level end up in the border cells, queries out there look at the same cells
+	x = std::min(std::max(x, 0), m_width - 1);
+	y = std::min(std::max(y, 0), m_height - 1);
+}
+
+void BoxGrid::unlink(int index){
+	int* link = &m_cellHeads[m_boxCells[index]];
+	while (*link != index)
+	{
+		link = &m_nextInCell[*link];
+	}
+	*link = m_nextInCell[index];
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <glm\glm.hpp>
+#include <vector>
+
+#include "Box.h"
+
+/// The boxes of one kind (ground, ladders, holes, ...) together with a uniform tile grid over them.
+/// Collision code asks for the boxes near an agent instead of looping over the whole level.
+/// Expects boxes that are at most one cell big, like the level tiles
+class BoxGrid
+{
+public:
+	BoxGrid();
+	~BoxGrid();
+
+	void init(int width, int height, float cellSize);
+
+	void clear();
+
+	void add(const Box& box);
+
+	/// Moves the last box into index, so like before the order of the other boxes changes
+	void remove(size_t index);
+
+	/// Writes the indices of all boxes that may overlap the rectangle into the returned vector, sorted
+	/// like the boxes are stored. The rectangle is grown by one cell, so an agent that gets pushed out of
+	/// a box during its collision checks still only meets boxes from the list.
+	/// The vector is reused by the next query
+	const std::vector<int>& query(glm::vec2 position, glm::vec2 dimensions);
+
+	size_t size() const { return m_boxes.size(); }
+	Box& operator[](size_t index) { return m_boxes[index]; }
+	const Box& operator[](size_t index) const { return m_boxes[index]; }
+
+	std::vector<Box>::iterator begin() { return m_boxes.begin(); }
+	std::vector<Box>::iterator end() { return m_boxes.end(); }
+	std::vector<Box>::const_iterator begin() const { return m_boxes.begin(); }
+	std::vector<Box>::const_iterator end() const { return m_boxes.end(); }
+
+private:
+	int getCell(glm::vec2 position) const;
+	void clampCell(int& x, int& y) const;
+	void unlink(int index);
+
+	int m_width = 1;
+	int m_height = 1;
+	float m_cellSize = 1.0f;
+	std::vector<Box> m_boxes;
+	std::vector<int> m_boxCells; ///< Cell of every box
+	std::vector<int> m_cellHeads; ///< First box in every cell, -1 = empty
+	std::vector<int> m_nextInCell; ///< Next box in the same cell, -1 = last
+	std::vector<int> m_queryResult;
+};
@@ -0,0 +1,231 @@
+#include "FlowField.h"
+
+#include <GameEngine\Profiler.h>
+
+//Distance of tiles that can't reach the target, small enough that INF + 1 doesn't overflow
+const int INF = 1 << 29;
+
+
+FlowField::FlowField()
+{
+}
+
+
+FlowField::~FlowField()
+{
+}
+
+bool FlowField::update(const SquareGrid& squareGrid, SquareGrid::Location target){
+	PROFILE_ZONE("FlowField::update");
+
+	if (target == m_target && squareGrid.version == m_gridVersion &&
+		squareGrid.width == m_width && squareGrid.height == m_height)
+	{
+		return false;
+	}
+
+	m_width = squareGrid.width;
+	m_height = squareGrid.height;
+	m_gridVersion = squareGrid.version;
+	m_target = target;
+	m_targetCell = squareGrid.in_bounds(target) ? cellOf(target) : -1;
+
+	int numCells = m_width * m_height;
+	m_distance.assign(numCells, INF);
+	m_next.resize(numCells);
+	m_open.clear();
+
+	if (m_targetCell == -1)
+	{
+		m_rhs = m_distance;
+		return true;
+	}
+
+	m_distance[m_targetCell] = 0;
+	m_next[m_targetCell] = m_targetCell;
+	m_open.push_back(OpenNode{ 0, m_targetCell });
+
+	SquareGrid::Neighbors neighbors;
+
+	//Outwards from the target, a neighbor steps onto current and pays its cost
+	while (!m_open.empty()) {
+		std::pop_heap(m_open.begin(), m_open.end(), std::greater<OpenNode>());
+		OpenNode current = m_open.back();
+		m_open.pop_back();
+
+		//Skip entries that were pushed again with a lower distance
+		if (current.key != m_distance[current.cell]) {
+			continue;
+		}
+
+		SquareGrid::Location location = locationOf(current.cell);
+		int numNeighbors = squareGrid.neighbors(location, neighbors);
+
+		for (int i = 0; i < numNeighbors; i++) {
+			int next = cellOf(neighbors[i]);
+			int nextDistance = current.key + squareGrid.cost(neighbors[i], location);
+			if (nextDistance < m_distance[next]) {
+				m_distance[next] = nextDistance;
+				m_next[next] = current.cell;
+				m_open.push_back(OpenNode{ nextDistance, next });
+				std::push_heap(m_open.begin(), m_open.end(), std::greater<OpenNode>());
+			}
+		}
+	}
+
+	//A fresh field is consistent everywhere
+	m_rhs = m_distance;
+
+	return true;
+}
+
+void FlowField::tile_changed(const SquareGrid& squareGrid, SquareGrid::Location changed){
+	PROFILE_ZONE("FlowField::tile_changed");
+
+	if (m_gridVersion != squareGrid.version - 1 || squareGrid.width != m_width || squareGrid.height != m_height)
+	{
+		//We missed an earlier change, update has to rebuild the whole field anyway
+		return;
+	}
+	m_gridVersion = squareGrid.version;
+
+	if (m_targetCell == -1 || !squareGrid.in_bounds(changed))
+	{
+		return;
+	}
+
+	//Passability decides the tile's own rhs, its cost the rhs of the neighbors stepping onto it
+	updateCell(squareGrid, cellOf(changed));
+
+	int x, y, dx, dy;
+	std::tie(x, y) = changed;
+	for (auto dir : SquareGrid::DIRS2) {
+		std::tie(dx, dy) = dir;
+		SquareGrid::Location neighbor(x + dx, y + dy);
+		if (squareGrid.in_bounds(neighbor)) {
+			updateCell(squareGrid, cellOf(neighbor));
+		}
+	}
+
+	computeDistances(squareGrid);
+}
+
+int FlowField::distance(SquareGrid::Location from) const {
+	int x, y;
+	std::tie(x, y) = from;
+	if (x < 0 || x >= m_width || y < 0 || y >= m_height || m_distance[cellOf(from)] >= INF)
+	{
+		return -1;
+	}
+	return m_distance[cellOf(from)];
+}
+
+bool FlowField::next_step(SquareGrid::Location from, SquareGrid::Location& next) const {
+	if (distance(from) < 0)
+	{
+		return false;
+	}
+
+	next = locationOf(m_next[cellOf(from)]);
+	return true;
+}
+
+bool FlowField::build_path(SquareGrid::Location from, std::vector<glm::vec2>& path) const {
+	path.clear();
+
+	if (distance(from) < 0)
+	{
+		return false;
+	}
+
+	int cell = cellOf(from);
+	path.push_back(glm::vec2(cell % m_width, cell / m_width));
+	while (cell != m_targetCell) {
+		cell = m_next[cell];
+		path.push_back(glm::vec2(cell % m_width, cell / m_width));
+	}
+
+	//The target ends up in front and from at the back, where the monster pops its next step
+	std::reverse(path.begin(), path.end());
+
+	return true;
+}
+
+int FlowField::cellOf(SquareGrid::Location location) const {
+	int x, y;
+	std::tie(x, y) = location;
+	return y * m_width + x;
+}
+
+SquareGrid::Location FlowField::locationOf(int cell) const {
+	return SquareGrid::Location(cell % m_width, cell / m_width);
+}
+
+void FlowField::updateCell(const SquareGrid& squareGrid, int cell){
+	if (cell != m_targetCell)
+	{
+		int rhs = INF;
+		int next = cell;
+
+		SquareGrid::Location location = locationOf(cell);
+		if (squareGrid.passable(location))
+		{
+			//Every in bounds neighbor can step onto a passable tile
+			int x, y, dx, dy;
+			std::tie(x, y) = location;
+			for (auto dir : SquareGrid::DIRS2) {
+				std::tie(dx, dy) = dir;
+				SquareGrid::Location neighbor(x + dx, y + dy);
+				if (squareGrid.in_bounds(neighbor)) {
+					int neighborCell = cellOf(neighbor);
+					int neighborRhs = m_distance[neighborCell] + squareGrid.cost(location, neighbor);
+					if (neighborRhs < rhs) {
+						rhs = neighborRhs;
+						next = neighborCell;
+					}
+				}
+			}
+		}
+
+		m_rhs[cell] = rhs >= INF ? INF : rhs;
+		m_next[cell] = next;
+	}
+
+	if (m_distance[cell] != m_rhs[cell])
+	{
+		m_open.push_back(OpenNode{ std::min(m_distance[cell], m_rhs[cell]), cell });
+		std::push_heap(m_open.begin(), m_open.end(), std::greater<OpenNode>());
+	}
+}
+
+void FlowField::computeDistances(const SquareGrid& squareGrid){
+	SquareGrid::Neighbors neighbors;
+
+	while (!m_open.empty()) {
+		std::pop_heap(m_open.begin(), m_open.end(), std::greater<OpenNode>());
+		OpenNode current = m_open.back();
+		m_open.pop_back();
+
+		int cell = current.cell;
+
+		//Skip cells that became consistent or were queued again with another key
+		if (m_distance[cell] == m_rhs[cell] || current.key != std::min(m_distance[cell], m_rhs[cell])) {
+			continue;
+		}
+
+		if (m_distance[cell] > m_rhs[cell]) {
+			//Got shorter, settle it like Dijkstra would
+			m_distance[cell] = m_rhs[cell];
+		}
+		else {
+			//Got longer, forget the old distance and let the neighbors offer a new one
+			m_distance[cell] = INF;
+			updateCell(squareGrid, cell);
+		}
+
+		int numNeighbors = squareGrid.neighbors(locationOf(cell), neighbors);
+		for (int i = 0; i < numNeighbors; i++) {
+			updateCell(squareGrid, cellOf(neighbors[i]));
+		}
+	}
+}
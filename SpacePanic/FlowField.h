@@ -0,0 +1,65 @@
+#pragma once
+
+#include <glm\glm.hpp>
+#include <vector>
+
+#include "PathFinder.h"
+
+/// Distance field towards one target tile (a player), built with Dijkstra over the tile costs.
+/// Every monster chasing that target reads its next step from the same field,
+/// so the path cost doesn't grow with the number of monsters
+class FlowField
+{
+public:
+	FlowField();
+	~FlowField();
+
+	/// Rebuilds the field if the target moved to another tile or the grid changed since the last build.
+	/// Returns true if it was rebuilt
+	bool update(const SquareGrid& squareGrid, SquareGrid::Location target);
+
+	/// Marks the field as outdated, the next update rebuilds it
+	void invalidate() { m_gridVersion = -1; }
+
+	/// Called after the passability or the cost of one tile changed (a hole was dug or filled).
+	/// Repairs only the distances that depend on that tile (LPA* without heuristic), if the field
+	/// was current right before the change. Otherwise it is left for the next update to rebuild
+	void tile_changed(const SquareGrid& squareGrid, SquareGrid::Location changed);
+
+	/// Summed tile costs from the tile to the target, -1 if it can't reach the target
+	int distance(SquareGrid::Location from) const;
+
+	/// Writes the tile one step closer to the target into next. O(1)
+	bool next_step(SquareGrid::Location from, SquareGrid::Location& next) const;
+
+	/// Writes the tiles from the target to from into path, in the same order as PathFinder::find_path.
+	/// Returns false (empty path) if from can't reach the target
+	bool build_path(SquareGrid::Location from, std::vector<glm::vec2>& path) const;
+
+private:
+	struct OpenNode {
+		int key; ///< min(distance, rhs) when the node was queued
+		int cell;
+
+		bool operator>(const OpenNode& other) const {
+			return key > other.key || (key == other.key && cell > other.cell);
+		}
+	};
+
+	int cellOf(SquareGrid::Location location) const;
+	SquareGrid::Location locationOf(int cell) const;
+
+	//Recomputes rhs and the next step of the cell from its neighbors and queues it if inconsistent
+	void updateCell(const SquareGrid& squareGrid, int cell);
+	void computeDistances(const SquareGrid& squareGrid);
+
+	int m_width = 0;
+	int m_height = 0;
+	int m_gridVersion = -1; ///< SquareGrid::version the field was built for
+	SquareGrid::Location m_target = SquareGrid::Location(-1, -1);
+	int m_targetCell = -1; ///< -1 if the target is outside the grid
+	std::vector<int> m_distance; ///< Cost to the target per tile, INF (see FlowField.cpp) = unreachable
+	std::vector<int> m_rhs; ///< One step lookahead of m_distance, differs only while repairing
+	std::vector<int> m_next; ///< Tile index one step closer to the target
+	std::vector<OpenNode> m_open; ///< Binary min heap for builds and repairs, keeps its capacity
+};
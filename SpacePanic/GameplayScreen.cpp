@@ -5,6 +5,7 @@
 #include <random>
 #include <ctime>
 #include <GameEngine\GameEngineErrors.h>
+#include <GameEngine\Profiler.h>
 
 #define DEBUG_RENDER
 
@@ -45,7 +46,7 @@ void GameplayScreen::onEntry() {
 	m_debugRenderer.init();
 
 	//Load the texture
-	m_texture = GameEngine::ResourceManager::getTexture("Assets/bricks_top.png");
+	m_texture = GameEngine::ResourceManager::getTextureAsync("Assets/bricks_top.png");
 
 	//Initialize the spriteBatch
 	m_spriteBatch.init();
@@ -80,36 +81,40 @@ void GameplayScreen::onEntry() {
 
 void GameplayScreen::onExit() {
 	m_debugRenderer.dispose();
+	m_spriteBatch.dispose();
+	m_hudSpriteBatch.dispose();
 	m_levels[m_currentLevel]->clear();
 	cleanLevel();
+	for (auto& level : m_levels)
+	{
+		level->dispose();
+	}
 }
 
 
-void GameplayScreen::update() {
+void GameplayScreen::update(float deltaTime) {
 
 	if (m_currentLevelState != LevelState::INIT)
 	{
-		m_camera.update();
-		m_hudCamera.update();
 		checkInput();
 		processInput();
 
 		if (!checkWinCondition() && m_currentLevelState != LevelState::GAMEOVER && m_currentLevelState != LevelState::LOSTALIVE && m_currentLevelState != LevelState::COMPLETED)
 		{ //The player hasn't won yet..
+			m_cameraFollowsPlayer = false;
 			if (m_levels[m_currentLevel]->getCameraPosition() != glm::vec2(0.0f, 0.0f))
 			{
 				m_camera.setPosition(m_levels[m_currentLevel]->getCameraPosition());
 			}
 			else if (m_players.size() > 0)
 			{
-				m_camera.setPosition(m_players[0]->getPosition());
+				m_cameraFollowsPlayer = true;
 			}
 			else{
 				m_camera.setPosition(glm::vec2(m_window->getScreenWidth() / 2, m_window->getScreenHeight() / 2));
 			}
 
-			updateAgents(1.0f);
-			updateLevel(*m_levels[m_currentLevel]);
+			updateAgents(deltaTime);
 		}
 		else if (checkWinCondition())
 		{ //The player won!
@@ -119,7 +124,15 @@ void GameplayScreen::update() {
 
 }
 
-void GameplayScreen::draw() {
+void GameplayScreen::draw(float alpha) {
+	//Following the interpolated player keeps it from jittering when there are more frames than ticks
+	if (m_cameraFollowsPlayer && m_players.size() > 0)
+	{
+		m_camera.setPosition(m_players[0]->getDrawPosition(alpha));
+	}
+	m_camera.update();
+	m_hudCamera.update();
+
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	glClearColor(0.5f, 0.5f, 0.5f, 1.0f);
 
@@ -147,7 +160,7 @@ void GameplayScreen::draw() {
 	{
 		if (m_camera.isBoxInView(m_players[i]->getPosition(), agentDims))
 		{
-			m_players[i]->draw(m_spriteBatch);
+			m_players[i]->draw(m_spriteBatch, alpha);
 		}
 	}
 
@@ -156,7 +169,7 @@ void GameplayScreen::draw() {
 	{
 		if (m_camera.isBoxInView(m_monsters[i]->getPosition(), agentDims))
 		{
-			m_monsters[i]->draw(m_spriteBatch);
+			m_monsters[i]->draw(m_spriteBatch, alpha);
 		}
 	}
 
@@ -184,7 +197,7 @@ void GameplayScreen::draw() {
 			m_debugRenderer.drawBox(destRect, GameEngine::ColorRGBA8(255, 255, 255, 255), 0.0f);
 		}
 
-		std::vector<Box> levelBoxes = m_levels[m_currentLevel]->getLevelBoxes();
+		BoxGrid& levelBoxes = m_levels[m_currentLevel]->getLevelBoxes();
 
 		for (auto& box : levelBoxes)
 		{
@@ -196,7 +209,7 @@ void GameplayScreen::draw() {
 			m_debugRenderer.drawBox(destRect, GameEngine::ColorRGBA8(255, 255, 255, 255), 0.0f);
 		}
 
-		std::vector<Box> holeBoxes = m_levels[m_currentLevel]->getHoleBoxes();
+		BoxGrid& holeBoxes = m_levels[m_currentLevel]->getHoleBoxes();
 
 		for (auto& box : holeBoxes)
 		{
@@ -208,7 +221,7 @@ void GameplayScreen::draw() {
 			m_debugRenderer.drawBox(destRect, GameEngine::ColorRGBA8(0, 255, 255, 255), 0.0f);
 		}
 
-		std::vector<Box> halfHoleBoxes = m_levels[m_currentLevel]->getHalfHoleBoxes();
+		BoxGrid& halfHoleBoxes = m_levels[m_currentLevel]->getHalfHoleBoxes();
 
 		for (auto& box : halfHoleBoxes)
 		{
@@ -345,6 +358,18 @@ void GameplayScreen::initLevel(Level* level){
 		m_monsters.back()->init(MONSTER_SPEED, monsterPosition, glm::vec2(80.0f, 60.0f), glm::vec2(60.0f, 128.0f));
 	}
 
+	m_agentGrid.init(glm::vec2(0.0f), glm::vec2(level->getWidth() * TILE_WIDTH, level->getHeight() * TILE_WIDTH), TILE_WIDTH * 2.0f);
+
+	//Nothing to interpolate from before the first tick
+	for (auto player : m_players)
+	{
+		player->beginTick(0.0f);
+	}
+	for (auto monster : m_monsters)
+	{
+		monster->beginTick(0.0f);
+	}
+
 	m_playersDead = 0;
 }
 
@@ -359,10 +384,20 @@ bool GameplayScreen::checkWinCondition(){
 }
 
 void GameplayScreen::updateAgents(float deltaTime){
+	PROFILE_ZONE("GameplayScreen::updateAgents");
 
 	int killPoints = 0;
 	Player* latestPlayerToKillMonster = nullptr; // TODO: change into vector?
-	glm::vec4 penetrationDepth;
+
+	//Start of the interpolation for drawing
+	for (auto player : m_players)
+	{
+		player->beginTick(deltaTime);
+	}
+	for (auto monster : m_monsters)
+	{
+		monster->beginTick(deltaTime);
+	}
 
 	//Update the players
 	for (auto player : m_players)
@@ -373,45 +408,28 @@ void GameplayScreen::updateAgents(float deltaTime){
 		}
 	}
 
+	//One distance field per player, only rebuilt when the player entered another tile or the map changed
+	for (size_t i = 0; i < m_players.size(); i++)
+	{
+		Level* level = m_levels[m_currentLevel];
+		level->getFlowField(i).update(level->getMap(), level->getTileLocation(m_players[i]->getBox().getPosition()));
+	}
+
+	//The monsters look up their nearest player in here, the players have their index as id
+	GameEngine::SpatialGrid& playerGrid = m_levels[m_currentLevel]->getPlayerGrid();
+	playerGrid.clear();
+	for (auto player : m_players)
+	{
+		playerGrid.add(glm::vec4(player->getPosition(), 0.0f, 0.0f));
+	}
+	playerGrid.build();
+
 	//Update the monsters
 	for (size_t i = 0; i < m_monsters.size(); i++)
 	{
 		if (m_monsters[i]->isAlive())
 		{ //The Monster is alive and kicking
 			m_monsters[i]->update(*m_levels[m_currentLevel], m_players, m_monsters, deltaTime);
-
-			for (auto player : m_players)
-			{
-				if (m_monsters[i]->collideWithAgent(player, penetrationDepth) && ((abs(penetrationDepth.z - penetrationDepth.x) >= 20) && abs(penetrationDepth.w - penetrationDepth.y) >= 65)){
-					std::printf("A player died :(");
-					//Mark the player as dead
-					player->kill();
-					m_playersDead++;
-
-					//Check if all players are dead
-					if (m_playersDead >= m_players.size())
-					{
-						if (player->getHealth()>0)
-						{
-							//change into the "you lost a live" state
-							m_currentLevelState = LevelState::LOSTALIVE;
-						}
-						else{
-							//change into game over state
-							m_currentLevelState = LevelState::GAMEOVER;
-						}
-						break;
-					}
-				}
-			}
-
-			for (size_t a = i + 1; a < m_monsters.size(); a++)
-			{
-				if (m_monsters[i]->collideWithAgent(m_monsters[a], penetrationDepth))
-				{
-					handleMonsterCollisionBehaviour(m_monsters[i], m_monsters[a], penetrationDepth);
-				}
-			}
 		}
 		else{ //Monster was killed by a player
 			//Add points to the player who killed the monster
@@ -438,10 +456,72 @@ void GameplayScreen::updateAgents(float deltaTime){
 		}
 	}
 
+	collideAgents();
 }
 
-void GameplayScreen::updateLevel(Level& level){
-	level.update();
+void GameplayScreen::collideAgents(){
+	PROFILE_ZONE("GameplayScreen::collideAgents");
+
+	//Monsters get the ids 0..n-1, the players follow after them
+	m_agentGrid.clear();
+	for (auto monster : m_monsters)
+	{
+		m_agentGrid.add(glm::vec4(monster->getBox().getPosition(), monster->getBox().getDimensions()));
+	}
+	for (auto player : m_players)
+	{
+		m_agentGrid.add(glm::vec4(player->getBox().getPosition(), player->getBox().getDimensions()));
+	}
+	m_agentGrid.build();
+
+	const int numMonsters = m_monsters.size();
+	glm::vec4 penetrationDepth;
+
+	for (auto& pair : m_agentGrid.findPairs())
+	{
+		//Players never collide with each other
+		if (pair.first >= numMonsters)
+		{
+			continue;
+		}
+
+		Monster* monster = m_monsters[pair.first];
+		if (!monster->isAlive())
+		{
+			continue;
+		}
+
+		if (pair.second < numMonsters)
+		{
+			if (m_monsters[pair.second]->isAlive() && monster->collideWithAgent(m_monsters[pair.second], penetrationDepth))
+			{
+				handleMonsterCollisionBehaviour(monster, m_monsters[pair.second], penetrationDepth);
+			}
+			continue;
+		}
+
+		Player* player = m_players[pair.second - numMonsters];
+		if (monster->collideWithAgent(player, penetrationDepth) && ((abs(penetrationDepth.z - penetrationDepth.x) >= 20) && abs(penetrationDepth.w - penetrationDepth.y) >= 65)){
+			std::printf("A player died :(");
+			//Mark the player as dead
+			player->kill();
+			m_playersDead++;
+
+			//Check if all players are dead
+			if (m_playersDead >= m_players.size())
+			{
+				if (player->getHealth()>0)
+				{
+					//change into the "you lost a live" state
+					m_currentLevelState = LevelState::LOSTALIVE;
+				}
+				else{
+					//change into game over state
+					m_currentLevelState = LevelState::GAMEOVER;
+				}
+			}
+		}
+	}
 }
 
 
@@ -8,6 +8,7 @@
 #include <GameEngine\GLTexture.h>
 #include <GameEngine\Window.h>
 #include <GameEngine\DebugRenderer.h>
+#include <GameEngine\SpatialGrid.h>
 
 #include "Level.h"
 #include "Box.h"
@@ -39,8 +40,8 @@ public:
 	virtual void onEntry() override;
 	virtual void onExit() override;
 
-	virtual void update() override;
-	virtual void draw() override;
+	virtual void update(float deltaTime) override;
+	virtual void draw(float alpha) override;
 
 private:
 	void checkInput();
@@ -59,10 +60,11 @@ private:
 	///Updates all agents
 	void updateAgents(float deltaTime);
 
-	void updateLevel(Level& level);
-
 	void handleMonsterCollisionBehaviour(Monster* a, Monster* b, glm::vec4 penetrationDepth);
 
+	//Monsters bumping into each other and killing players, only for the pairs the agent grid reports
+	void collideAgents();
+
 	/// Draws the HUD
 	void drawHUD();
 
@@ -81,6 +83,7 @@ private:
 	GameEngine::Window* m_window;
 	GameEngine::DebugRenderer m_debugRenderer;
 
+	bool m_cameraFollowsPlayer = false; ///< The camera moves with the interpolated first player while drawing
 	bool m_renderDebug = false;
 	bool m_playMusic = true;
 
@@ -89,6 +92,7 @@ private:
 	std::vector<Player*> m_players; ///< Vector of players alive
 //	std::vector<Player*> m_deadPlayers; ///< Vector of players dead
 	std::vector<Monster*> m_monsters; ///< Vector of all monsters alive
+	GameEngine::SpatialGrid m_agentGrid; ///< Broadphase for agent vs agent collisions, rebuilt every frame
 
 	//std::vector<Box> m_boxes;
 
@@ -1,32 +1,36 @@
 #include "Level.h"
 #include <GameEngine\GameEngineErrors.h>
-#include <fstream>
+#include <GameEngine\Profiler.h>
+#include <GameEngine\IOManager.h>
+#include <sstream>
+#include <cmath>
 
 
 #include <GameEngine\ResourceManager.h>
 #include "PathFinder.h"
 
 
+const int HOLE_COST = 4; ///< Of stepping onto the tile above an open hole, a normal tile costs 1
+
 
 Level::Level(const std::string fileName) : m_map(1, 1)
 {
-	std::fstream file;
-	file.open(fileName);
+	GameEngine::FileView file;
 
 	//Error checking
-	if (file.fail())
+	if (!file.open(fileName))
 	{
 		GameEngine::fatalError("Failed to open " + fileName);
 	}
 
 	//Throw away the first sting in tap
+	size_t position = 0;
 	std::string tmp;
-	file >> tmp >> m_numPlayer;
-
-	std::getline(file, tmp); //Throw away the rest of the first line
+	file.getLine(position, tmp);
+	std::istringstream(tmp) >> tmp >> m_numPlayer;
 
 	//Read the level data
-	while (std::getline(file, tmp)){
+	while (file.getLine(position, tmp)){
 		m_levelData.push_back(tmp);
 	}
 
@@ -42,32 +46,86 @@ Level::~Level()
 
 void Level::reload(){
 	clear();
+	m_map.clear_walls();
+	m_map.clear_costs(); //Drops the costs of holes that were open when the level ended
 	progressLevelData();
 }
 
-void Level::update(){
-	m_spriteBatch.begin();
-	for (auto box : m_boxes)
+void Level::draw(){
+	m_spriteBatch.renderBatch();
+}
+
+void Level::updateTile(const Box& box){
+	int x = (int)floor(box.getPosition().x / TILE_WIDTH + 0.5f);
+	int y = (int)floor(box.getPosition().y / TILE_WIDTH + 0.5f);
+
+	if (x < 0 || x >= getWidth() || y < 0 || y >= getHeight())
 	{
-		box.draw(m_spriteBatch);
+		return;
 	}
-	for (auto box : m_ladderBoxes)
+
+	int spriteIndex = m_tileSprites[y * getWidth() + x];
+	if (spriteIndex >= 0)
 	{
-		box.draw(m_spriteBatch);
+		m_spriteBatch.updateStaticSprite(spriteIndex, box.getDestRect(), box.getUVRect(), box.getTextureID(), 0.0f, box.getColor());
 	}
-	for (auto box : m_halfHoleBoxes)
+}
+
+void Level::setHoleOpen(const Box& groundBox, bool open){
+	PROFILE_ZONE("Level::setHoleOpen");
+
+	int x = (int)floor(groundBox.getPosition().x / TILE_WIDTH + 0.5f);
+	int y = (int)floor(groundBox.getPosition().y / TILE_WIDTH + 0.5f) + 1;
+
+	SquareGrid::Location aboveHole(x, y);
+	int cost = open ? HOLE_COST : 1;
+	if (!m_map.in_bounds(aboveHole) || m_map.tile_cost(aboveHole) == cost)
 	{
-		box.draw(m_spriteBatch);
+		return;
 	}
-	for (auto box : m_holeBoxes)
+
+	//Monsters still walk over an open hole (and fall into it), they only prefer a short way around
+	m_map.set_tile_cost(aboveHole, cost);
+
+	for (auto& flowField : m_flowFields)
 	{
-		box.draw(m_spriteBatch);
+		flowField.tile_changed(m_map, aboveHole);
 	}
-	m_spriteBatch.end();
 }
 
-void Level::draw(){
-	m_spriteBatch.renderBatch();
+void Level::addWalls(const std::vector<std::string>& levelData, SquareGrid& map){
+	for (int y = 0; y < levelData.size(); y++)
+	{
+		for (int x = 0; x < levelData[y].size(); x++)
+		{
+			char tile = levelData[y][x];
+			if (tile == 'R' || tile == 'G' || tile == 'W')
+			{
+				map.add_wall(std::tie(x, y));
+			}
+			//Monsters walk on bricks and ground or climb ladders, everything else is air
+			else if (tile != 'L' && (y == 0 || (levelData[y - 1][x] != 'R' && levelData[y - 1][x] != 'G')))
+			{
+				map.add_wall(std::tie(x, y));
+			}
+		}
+	}
+}
+
+void Level::dispose(){
+	m_spriteBatch.dispose();
+}
+
+FlowField& Level::getFlowField(int playerIndex){
+	if (playerIndex >= m_flowFields.size())
+	{
+		m_flowFields.resize(playerIndex + 1);
+	}
+	return m_flowFields[playerIndex];
+}
+
+SquareGrid::Location Level::getTileLocation(glm::vec2 position) const{
+	return SquareGrid::Location((int)round(position.x / TILE_WIDTH), (int)round(position.y / TILE_WIDTH));
 }
 
 void Level::clear(){
@@ -82,6 +140,15 @@ void Level::progressLevelData(){
 	m_spriteBatch.init();
 	m_spriteBatch.begin();
 
+	m_tileSprites.assign(getWidth() * getHeight(), -1);
+
+	m_boxes.init(getWidth(), getHeight(), TILE_WIDTH);
+	m_ladderBoxes.init(getWidth(), getHeight(), TILE_WIDTH);
+	m_halfHoleBoxes.init(getWidth(), getHeight(), TILE_WIDTH);
+	m_holeBoxes.init(getWidth(), getHeight(), TILE_WIDTH);
+	m_playerGrid.init(glm::vec2(0.0f), glm::vec2(getWidth() * TILE_WIDTH, getHeight() * TILE_WIDTH), TILE_WIDTH * 2.0f);
+	int numSprites = 0;
+
 	glm::vec4 uvRect(0.0f, 0.0f, 1.0f, 1.0f);
 	GameEngine::ColorRGBA8 whiteColor;
 	whiteColor.r = 255;
@@ -91,6 +158,8 @@ void Level::progressLevelData(){
 
 	GameEngine::ColorRGBA8 blackColor(0,0,0,255);
 
+	addWalls(m_levelData, m_map);
+
 	// Render all the tiles
 	for (int y = 0; y < m_levelData.size(); y++)
 	{
@@ -109,30 +178,29 @@ void Level::progressLevelData(){
 			case 'B':
 				break;
 			case 'R':
-				newBox.init(glm::vec2(x * TILE_WIDTH, y * TILE_WIDTH), glm::vec2(TILE_WIDTH, TILE_WIDTH), &GameEngine::ResourceManager::getTexture("Textures/red_bricks.png"), GameEngine::ColorRGBA8(0, 255, 255, 255), uvRect);
-				m_boxes.push_back(newBox);
-
-				m_map.walls.emplace(std::tie(x, y));
+				newBox.init(glm::vec2(x * TILE_WIDTH, y * TILE_WIDTH), glm::vec2(TILE_WIDTH, TILE_WIDTH), &GameEngine::ResourceManager::getAtlasTextureAsync("Textures/red_bricks.png"), GameEngine::ColorRGBA8(0, 255, 255, 255), uvRect);
+				m_boxes.add(newBox);
 
 				//Draw the box
 				newBox.draw(m_spriteBatch);
+				m_tileSprites[y * getWidth() + x] = numSprites++;
 				break;
 			case 'G':
 				//ground
-				newBox.init(glm::vec2(x * TILE_WIDTH, y * TILE_WIDTH), glm::vec2(TILE_WIDTH, TILE_WIDTH), &GameEngine::ResourceManager::getTexture("Textures/glass.png"), blackColor, uvRect);
-				m_boxes.push_back(newBox);
-
-				m_map.walls.emplace(std::tie(x, y));
+				newBox.init(glm::vec2(x * TILE_WIDTH, y * TILE_WIDTH), glm::vec2(TILE_WIDTH, TILE_WIDTH), &GameEngine::ResourceManager::getAtlasTextureAsync("Textures/glass.png"), blackColor, uvRect);
+				m_boxes.add(newBox);
 
 				//Draw the box
 				newBox.draw(m_spriteBatch);
+				m_tileSprites[y * getWidth() + x] = numSprites++;
 				break;
 			case 'L':
-				newBox.init(glm::vec2(x * TILE_WIDTH, y * TILE_WIDTH), glm::vec2(TILE_WIDTH, TILE_WIDTH), &GameEngine::ResourceManager::getTexture("Textures/light_bricks.png"), GameEngine::ColorRGBA8(255, 0, 255, 255), uvRect);
-				m_ladderBoxes.push_back(newBox);
+				newBox.init(glm::vec2(x * TILE_WIDTH, y * TILE_WIDTH), glm::vec2(TILE_WIDTH, TILE_WIDTH), &GameEngine::ResourceManager::getAtlasTextureAsync("Textures/light_bricks.png"), GameEngine::ColorRGBA8(255, 0, 255, 255), uvRect);
+				m_ladderBoxes.add(newBox);
 
 				//Draw the box
 				newBox.draw(m_spriteBatch);
+				m_tileSprites[y * getWidth() + x] = numSprites++;
 
 				break;
 			case '@':
@@ -147,13 +215,12 @@ void Level::progressLevelData(){
 			case '.':
 				break;
 			case 'W': //wall
-				newBox.init(glm::vec2(x * TILE_WIDTH, y * TILE_WIDTH), glm::vec2(TILE_WIDTH, TILE_WIDTH), &GameEngine::ResourceManager::getTexture("Textures/glass.png"), GameEngine::ColorRGBA8(0, 0, 0, 0), uvRect);
-				m_boxes.push_back(newBox);
-
-				m_map.walls.emplace(std::tie(x, y));
+				newBox.init(glm::vec2(x * TILE_WIDTH, y * TILE_WIDTH), glm::vec2(TILE_WIDTH, TILE_WIDTH), &GameEngine::ResourceManager::getAtlasTextureAsync("Textures/glass.png"), GameEngine::ColorRGBA8(0, 0, 0, 0), uvRect);
+				m_boxes.add(newBox);
 
 				//Draw the box
 				newBox.draw(m_spriteBatch);
+				m_tileSprites[y * getWidth() + x] = numSprites++;
 				break;
 			case 'C':
 				m_levelData[y][x] = '.';
@@ -164,19 +231,9 @@ void Level::progressLevelData(){
 				std::printf("Unexpected symbol %c at (%d, %e)", tile, x, y);
 				break;
 			}
-
-			if (tile != 'R' && tile != 'G' &&  tile != 'W')
-				{
-					if (0 <= y - 1 < m_levelData.size() &&
-						(m_levelData[y][x] != 'L' && m_levelData[y-1][x] != 'R' && m_levelData[y-1][x] != 'G'))
-					{
-						m_map.walls.emplace(std::tie(x, y));
-					}
-				}
-
 		}
 
 	}
-	m_spriteBatch.end();
+	m_spriteBatch.endStatic();
 
 }
@@ -2,9 +2,12 @@
 
 
 #include <GameEngine\SpriteBatch.h>
+#include <GameEngine\SpatialGrid.h>
 #include "Box.h"
+#include "BoxGrid.h"
 //#include "LevelNode.h"
 #include "PathFinder.h"
+#include "FlowField.h"
 
 
 
@@ -22,12 +25,19 @@ public:
 
 	void reload();
 
-	void update();
-
 	void draw();
 
+	//Writes the new look of a dug or refilled tile into the retained tile batch
+	void updateTile(const Box& box);
+
+	//Raises or resets the cost of the tile above a fully dug ground box and lets the flow fields repair themselves
+	void setHoleOpen(const Box& groundBox, bool open);
+
 	void clear();
 
+	//Frees the GL buffers of the tile batch, reload() creates them again
+	void dispose();
+
 	//Getters
 	const std::vector<std::string>& getLevelData(){ return m_levelData; }
 
@@ -43,15 +53,23 @@ public:
 		return m_levelData.size();
 	}
 
-	std::vector<Box>& getLevelBoxes() { return m_boxes; }
-	std::vector<Box>& getLadderBoxes() { return m_ladderBoxes; }
-	std::vector<Box>& getHalfHoleBoxes() { return m_halfHoleBoxes; }
-	std::vector<Box>& getHoleBoxes() { return m_holeBoxes; }
+	BoxGrid& getLevelBoxes() { return m_boxes; }
+	BoxGrid& getLadderBoxes() { return m_ladderBoxes; }
+	BoxGrid& getHalfHoleBoxes() { return m_halfHoleBoxes; }
+	BoxGrid& getHoleBoxes() { return m_holeBoxes; }
 
 	glm::vec2 getCameraPosition() const { return m_cameraPosition; }
 
 	//std::vector<LevelNode>& getLevelMap() { return m_levelMap; }
 	SquareGrid& getMap() { return m_map; }
+	FlowField& getFlowField(int playerIndex); ///< Distance field towards the player, shared by all monsters
+	GameEngine::SpatialGrid& getPlayerGrid() { return m_playerGrid; } ///< Players by index, rebuilt every update for the monsters' target queries
+
+	//Rounds a world position to the tile it is standing on
+	SquareGrid::Location getTileLocation(glm::vec2 position) const;
+
+	//Marks every tile of the level data a monster can't stand on as a wall of map. Needs no GL context
+	static void addWalls(const std::vector<std::string>& levelData, SquareGrid& map);
 
 private:
 
@@ -63,13 +81,16 @@ private:
 
 	std::vector<std::string> m_levelData;
 	int m_numPlayer;
-	GameEngine::SpriteBatch m_spriteBatch;
-	std::vector<Box> m_boxes;
-	std::vector<Box> m_ladderBoxes;
-	std::vector<Box> m_halfHoleBoxes;
-	std::vector<Box> m_holeBoxes;
+	GameEngine::SpriteBatch m_spriteBatch; ///< Static layer, only patched when a tile changes
+	std::vector<int> m_tileSprites; ///< Sprite index of every tile in m_spriteBatch, -1 for empty tiles
+	BoxGrid m_boxes;
+	BoxGrid m_ladderBoxes;
+	BoxGrid m_halfHoleBoxes;
+	BoxGrid m_holeBoxes;
 	//std::vector<LevelNode> m_levelMap;
 	SquareGrid m_map;
+	std::vector<FlowField> m_flowFields; ///< One per player
+	GameEngine::SpatialGrid m_playerGrid;
 
 	glm::vec2 m_startPlayerPos;
 	std::vector<glm::vec2> m_startMonsterPositions;
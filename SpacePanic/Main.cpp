@@ -1,7 +1,20 @@
 #include <GameEngine\IMainGame.h>
+#include <GameEngine\IOManager.h>
 #include "App.h"
+#include "PathFinderBenchmark.h"
+
+#include <cstring>
 
 int main(int argc, char** argv) {
+	//Release builds ship their assets in one pack, without it the loose files are used
+	GameEngine::IOManager::mountPack("Assets.pak");
+
+	if (argc > 1 && strcmp(argv[1], "--benchmark") == 0)
+	{
+		runPathFinderBenchmark();
+		return 0;
+	}
+
 	App app;
 	app.run();
 
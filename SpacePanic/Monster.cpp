@@ -6,6 +6,8 @@
 #include <random>
 #include <ctime>
 
+//A player at most this far above or below the monster is on its floor
+const float SAME_FLOOR_DISTANCE = 64.0f;
 
 
 Monster::Monster()
@@ -21,7 +23,7 @@ Monster::~Monster()
 
 void Monster::init(float speed, glm::vec2 position, const glm::vec2 drawDims, const glm::vec2 collisionDims){
 	m_speed = speed;
-	m_collisionBox.init(position, collisionDims, &GameEngine::ResourceManager::getTexture("Assets/cvJmPda.png"), glm::ivec2(3, 2), GameEngine::ColorRGBA8(255, 255, 255, 255));
+	m_collisionBox.init(position, collisionDims, &GameEngine::ResourceManager::getAtlasTextureAsync("Assets/cvJmPda.png"), glm::ivec2(3, 2), GameEngine::ColorRGBA8(255, 255, 255, 255));
 	m_collisionBox.setDrawDims(drawDims);
 }
 
@@ -51,7 +53,7 @@ void Monster::update(std::vector<Box>& levelBoxes, std::vector<Player*>& players
 }
 
 void Monster::update(Level& level, std::vector<Player*>& players, std::vector<Monster*>& monsters, float deltaTime){
-	Player* closestPlayer = getNearestPlayer(players);
+	Player* closestPlayer = getNearestPlayer(level, players);
 
 	static std::mt19937 randomEngine(time(nullptr));
 
@@ -89,10 +91,16 @@ void Monster::update(Level& level, std::vector<Player*>& players, std::vector<Mo
 
 	if (m_inHoleCounter == 0){
 
+		//A hole was dug or filled since we took the path, the flow field is already repaired so just walk it again
+		if (players[0] != nullptr && m_futurePath.size() != 0 && m_pathVersion != level.getMap().version)
+		{
+			determinePathToPlayer(level, monsters, *players[0]);
+		}
+
 		if (players[0] != nullptr && m_futurePath.size() == 0 && m_sawPlayer == true)
 		{
 			m_animTime = 0.0f;
-			m_futurePath = determinePathToPlayer(level, monsters, *players[0]);
+			determinePathToPlayer(level, monsters, *players[0]);
 			m_calculatedNewPath = true;
 			if (m_futurePath.size() != 0)
 			{
@@ -295,10 +303,15 @@ void Monster::update(Level& level, std::vector<Player*>& players, std::vector<Mo
 
 }
 
-bool Monster::collideWithHalfHole(std::vector<Box>& levelBoxes){
+bool Monster::collideWithHalfHole(BoxGrid& halfHoleBoxes){
+
+	//Also look one tile below the agent, the box above a hole counts too
+	glm::vec2 queryPosition(m_collisionBox.m_position.x, m_collisionBox.m_position.y - TILE_WIDTH);
+	glm::vec2 queryDimensions(m_collisionBox.m_dimensions.x, m_collisionBox.m_dimensions.y + TILE_WIDTH);
 
-	for (auto box : levelBoxes)
+	for (int index : halfHoleBoxes.query(queryPosition, queryDimensions))
 	{
+		Box& box = halfHoleBoxes[index];
 		glm::vec4 penetrationDepth;
 		if (collideWithBox(&box, penetrationDepth) == true)
 		{
@@ -326,9 +339,14 @@ bool Monster::collideWithHalfHole(std::vector<Box>& levelBoxes){
 	return false;
 }
 
-bool Monster::collideWithHole(std::vector<Box>& levelBoxes){
-	for (auto box : levelBoxes)
+bool Monster::collideWithHole(BoxGrid& holeBoxes){
+	//Also look one tile below the agent, the box above a hole counts too
+	glm::vec2 queryPosition(m_collisionBox.m_position.x, m_collisionBox.m_position.y - TILE_WIDTH);
+	glm::vec2 queryDimensions(m_collisionBox.m_dimensions.x, m_collisionBox.m_dimensions.y + TILE_WIDTH);
+
+	for (int index : holeBoxes.query(queryPosition, queryDimensions))
 	{
+		Box& box = holeBoxes[index];
 		glm::vec4 penetrationDepth;
 		if (collideWithBox(&box, penetrationDepth) == true)
 		{
@@ -365,7 +383,7 @@ Player* Monster::getNearestPlayer(std::vector<Player*>& players){
 	{
 		float distance;
 
-		if (abs(players[i]->getPosition().y - m_collisionBox.m_position.y) <= 64){
+		if (abs(players[i]->getPosition().y - m_collisionBox.m_position.y) <= SAME_FLOOR_DISTANCE){
 			distance = abs(players[i]->getPosition().x - m_collisionBox.m_position.x);
 
 			if (distance < smallestDistance){
@@ -378,13 +396,41 @@ Player* Monster::getNearestPlayer(std::vector<Player*>& players){
 	return closestPlayer;
 }
 
+Player* Monster::getNearestPlayer(Level& level, std::vector<Player*>& players){
+	Player* closestPlayer = nullptr;
+	float smallestDistance = 999999999999.0f;
+
+	//Same rule as above, but only the band of the level around the monster's floor is searched.
+	//The grid reports points strictly inside the band, so it reaches one unit past the level and the floor distance
+	glm::vec2 position = m_collisionBox.m_position;
+	float levelWidth = level.getWidth() * TILE_WIDTH;
+	glm::vec4 floorBand(-1.0f, position.y - SAME_FLOOR_DISTANCE - 1.0f, levelWidth + 2.0f, SAME_FLOOR_DISTANCE * 2.0f + 2.0f);
+	level.getPlayerGrid().query(floorBand, m_nearbyPlayers);
+
+	for (int i : m_nearbyPlayers)
+	{
+		float distance;
+
+		if (abs(players[i]->getPosition().y - position.y) <= SAME_FLOOR_DISTANCE){
+			distance = abs(players[i]->getPosition().x - position.x);
+
+			if (distance < smallestDistance){
+				smallestDistance = distance;
+				closestPlayer = players[i];
+			}
+		}
+	}
+
+	return closestPlayer;
+}
+
 void Monster::setDirection(glm::vec2 newDirection){
 	m_direction = newDirection;
 	m_directionSteps = 10;
 }
 
 
-void Monster::draw(GameEngine::SpriteBatch& spriteBatch){
+void Monster::draw(GameEngine::SpriteBatch& spriteBatch, float alpha){
 	glm::vec4 uvRect;
 
 	int tileIndex;
@@ -403,9 +449,9 @@ void Monster::draw(GameEngine::SpriteBatch& spriteBatch){
 	numTiles = 3;
 	animSpeed = 10 * 0.025f;
 
-	//Increment animation time
-	//TODO: add deltaTime
-	m_animTime += animSpeed;
+	//Increment animation time by the ticks since the last draw
+	m_animTime += animSpeed * m_animFrames;
+	m_animFrames = 0.0f;
 
 	//Apply animation
 	tileIndex = tileIndex + ((int)m_animTime % numTiles);
@@ -416,7 +462,7 @@ void Monster::draw(GameEngine::SpriteBatch& spriteBatch){
 	//Check direction
 	if (m_direction == glm::vec2(-1.0f, 0.0f))
 	{
-		uvRect.x += 1.0f / m_collisionBox.m_texture.dims.x;
+		uvRect.x += uvRect.z;
 		uvRect.z *= -1;
 	}
 
@@ -426,7 +472,7 @@ void Monster::draw(GameEngine::SpriteBatch& spriteBatch){
 	//set destRect
 	glm::vec4 destRect;
 
-	glm::vec2 position = m_collisionBox.getPosition();
+	glm::vec2 position = getDrawPosition(alpha);
 	glm::vec2 dimensions = m_collisionBox.getDimensions();
 
 	glm::vec2 drawDims = m_collisionBox.getDrawDims();
@@ -459,33 +505,13 @@ void Monster::changeDirectionTo(Box& box){
 	m_direction = glm::normalize(diff);
 }
 
-std::vector<glm::vec2> Monster::determinePathToPlayer(Level& level, std::vector<Monster*>& monsters, Player& player){
-	glm::vec2 playerTilePosition = glm::vec2(round(player.getBox().getPosition().x / TILE_WIDTH), round(player.getBox().getPosition().y / TILE_WIDTH));
-
-	float restX = std::fmod(player.getBox().getPosition().x, TILE_WIDTH);
-	float restY = std::fmod(player.getBox().getPosition().y, TILE_WIDTH);
-
-	std::vector<glm::vec2> result = determinePathTo(level, monsters,
-		glm::vec2(round(player.getBox().getPosition().x / TILE_WIDTH), round(player.getBox().getPosition().y / TILE_WIDTH)),
-		glm::vec2(round(m_collisionBox.getPosition().x / TILE_WIDTH), round(m_collisionBox.getPosition().y / TILE_WIDTH)));
-
-	return result;
-}
-
-std::vector<glm::vec2> Monster::determinePathTo(Level& level, std::vector<Monster*>& monsters, glm::vec2 startP, glm::vec2 goalP){
-
-	SquareGrid::Location start = std::tie(startP.x, startP.y);
-	SquareGrid::Location goal = std::tie(goalP.x, goalP.y);
-
-	std::vector<glm::vec2> result;
-
-	std::unordered_map<typename SquareGrid::Location, typename SquareGrid::Location> came_from;
-	std::unordered_map<typename SquareGrid::Location, int> cost_so_far;
-
-	came_from = pathfinder.a_star_search(level.getMap(), start, goal, came_from, cost_so_far);
+void Monster::determinePathToPlayer(Level& level, std::vector<Monster*>& monsters, Player& player){
+	//Usually the GameplayScreen already brought the field up to date this frame, then update is a no-op
+	FlowField& flowField = level.getFlowField(0);
+	flowField.update(level.getMap(), level.getTileLocation(player.getBox().getPosition()));
 
-	result = pathfinder.reconstruct_path2(start, goal, came_from);
-	return result;
+	flowField.build_path(level.getTileLocation(m_collisionBox.getPosition()), m_futurePath);
+	m_pathVersion = level.getMap().version;
 }
 
 bool Monster::changeDirectionToFuturePath(){
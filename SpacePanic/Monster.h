@@ -47,12 +47,12 @@ public:
 
 	virtual void update(Level& level, std::vector<Player*>& players, std::vector<Monster*>& monsters, float deltaTime) override;
 
-	virtual bool collideWithHalfHole(std::vector<Box>& levelBoxes) override;
-	virtual bool collideWithHole(std::vector<Box>& levelBoxes) override;
+	virtual bool collideWithHalfHole(BoxGrid& halfHoleBoxes) override;
+	virtual bool collideWithHole(BoxGrid& holeBoxes) override;
 
 	void setDirection(glm::vec2 newDirection);
 
-	void draw(GameEngine::SpriteBatch& spriteBatch);
+	void draw(GameEngine::SpriteBatch& spriteBatch, float alpha);
 
 	void kill(Player* killedBy);
 
@@ -90,9 +90,10 @@ public:
 private:
 
 	Player* getNearestPlayer(std::vector<Player*>& Player);
+	Player* getNearestPlayer(Level& level, std::vector<Player*>& players); ///< Uses the level's player grid
 	void changeDirectionTo(Box& box);
-	std::vector<glm::vec2> determinePathToPlayer(Level& level, std::vector<Monster*>& monsters, Player& player);
-	std::vector<glm::vec2> determinePathTo(Level& level, std::vector<Monster*>& monsters, glm::vec2 startP, glm::vec2 goalP);
+	//Writes into m_futurePath, which keeps its capacity between searches
+	void determinePathToPlayer(Level& level, std::vector<Monster*>& monsters, Player& player);
 	bool changeDirectionToFuturePath();
 
 	//std::unordered_map<LevelNode, LevelNode>& useAStarSearch(
@@ -122,9 +123,10 @@ private:
 	Player* m_killedBy;
 	bool m_inAir = false;
 	std::vector<glm::vec2> m_futurePath;
+	std::vector<int> m_nearbyPlayers; ///< Result of the player grid query, keeps its capacity
+	int m_pathVersion = -1; ///< SquareGrid::version m_futurePath was taken for
 	bool m_calculatedNewPath = false;
     bool m_reachedNextStep = true;
-	PathFinder pathfinder = PathFinder();
 	float m_animTime = 0.0f;
 };
 
@@ -1,5 +1,7 @@
 #include "PathFinder.h"
 
+#include <GameEngine\Profiler.h>
+
 
 //Location east = Location{ 1, 0 };
 //Location south =  Location{ 0, -1 };
@@ -71,7 +73,10 @@ unordered_map<SquareGrid::Location, int>& cost_so_far)
 			break;
 		}
 
-		for (auto next : squareGrid.neighbors(current)) {
+		SquareGrid::Neighbors neighbors;
+		int numNeighbors = squareGrid.neighbors(current, neighbors);
+		for (int i = 0; i < numNeighbors; i++) {
+			const SquareGrid::Location& next = neighbors[i];
 			int new_cost = cost_so_far[current] + squareGrid.cost(current, next);
 			if (!cost_so_far.count(next) || new_cost < cost_so_far[next]) {
 				cost_so_far[next] = new_cost;
@@ -125,6 +130,108 @@ std::vector<glm::vec2> PathFinder::reconstruct_path2(
 }
 
 
+void PathFinder::prepareSearch(const SquareGrid& squareGrid){
+	if (squareGrid.width != m_width || squareGrid.height != m_height)
+	{
+		m_width = squareGrid.width;
+		m_height = squareGrid.height;
+
+		int numCells = m_width * m_height;
+		m_visited.assign(numCells, 0);
+		m_cost.resize(numCells);
+		m_parent.resize(numCells);
+		m_generation = 0;
+	}
+
+	m_generation++;
+	if (m_generation == 0)
+	{
+		//The counter wrapped around, old stamps could look current again
+		std::fill(m_visited.begin(), m_visited.end(), 0);
+		m_generation = 1;
+	}
+
+	m_open.clear();
+}
+
+bool PathFinder::find_path(const SquareGrid& squareGrid, SquareGrid::Location start, SquareGrid::Location goal, std::vector<glm::vec2>& path){
+	PROFILE_ZONE("PathFinder::find_path");
+
+	path.clear();
+
+	if (!squareGrid.in_bounds(start) || !squareGrid.in_bounds(goal))
+	{
+		return false;
+	}
+
+	prepareSearch(squareGrid);
+
+	int startX, startY, goalX, goalY;
+	std::tie(startX, startY) = start;
+	std::tie(goalX, goalY) = goal;
+
+	const int startCell = startX * m_height + startY;
+	const int goalCell = goalX * m_height + goalY;
+
+	m_visited[startCell] = m_generation;
+	m_cost[startCell] = 0;
+	m_parent[startCell] = startCell;
+	m_open.push_back(OpenNode{ 0, startCell });
+
+	bool reachedGoal = false;
+	SquareGrid::Neighbors neighbors;
+
+	while (!m_open.empty()) {
+		std::pop_heap(m_open.begin(), m_open.end(), std::greater<OpenNode>());
+		OpenNode current = m_open.back();
+		m_open.pop_back();
+
+		if (current.cell == goalCell) {
+			reachedGoal = true;
+			break;
+		}
+
+		int x = current.cell / m_height;
+		int y = current.cell % m_height;
+
+		//Skip entries that were pushed again with a lower cost
+		if (current.priority > m_cost[current.cell] + abs(x - goalX) + abs(y - goalY)) {
+			continue;
+		}
+
+		int numNeighbors = squareGrid.neighbors(SquareGrid::Location(x, y), neighbors);
+		for (int i = 0; i < numNeighbors; i++) {
+			int nextX, nextY;
+			std::tie(nextX, nextY) = neighbors[i];
+			int next = nextX * m_height + nextY;
+
+			int new_cost = m_cost[current.cell] + squareGrid.cost(SquareGrid::Location(x, y), neighbors[i]);
+			if (m_visited[next] != m_generation || new_cost < m_cost[next]) {
+				m_visited[next] = m_generation;
+				m_cost[next] = new_cost;
+				m_parent[next] = current.cell;
+
+				m_open.push_back(OpenNode{ new_cost + abs(nextX - goalX) + abs(nextY - goalY), next });
+				std::push_heap(m_open.begin(), m_open.end(), std::greater<OpenNode>());
+			}
+		}
+	}
+
+	if (!reachedGoal) {
+		return false;
+	}
+
+	//Walk back from the goal and flip the result so it starts at start
+	for (int cell = goalCell; cell != startCell; cell = m_parent[cell]) {
+		path.push_back(glm::vec2(cell / m_height, cell % m_height));
+	}
+	path.push_back(glm::vec2(startX, startY));
+	std::reverse(path.begin(), path.end());
+
+	return true;
+}
+
+
 void PathFinder::draw_grid(const SquareGrid& graph, int field_width,
 	std::unordered_map<SquareGrid::Location, int>* distances,
 	std::unordered_map<SquareGrid::Location, SquareGrid::Location>* point_to,
@@ -133,7 +240,7 @@ void PathFinder::draw_grid(const SquareGrid& graph, int field_width,
 		for (int x = 0; x != graph.width; ++x) {
 			SquareGrid::Location id{ x, y };
 			std::cout << std::left << std::setw(field_width);
-			if (graph.walls.count(id)) {
+			if (!graph.passable(id)) {
 				std::cout << string(field_width, '#');
 			}
 			else if (point_to != nullptr && point_to->count(id)) {
@@ -56,13 +56,53 @@ struct SimpleGraph {
 
 struct SquareGrid {
 	typedef std::tuple<int, int> Location;
+	static const int MAX_NEIGHBORS = 4;
+	typedef std::array<Location, MAX_NEIGHBORS> Neighbors;
 	static std::array<Location, 4> DIRS2;
 
 	int width, height;
-	std::unordered_set<Location> walls;
+	std::vector<unsigned char> walls; ///< One byte per tile, 1 = wall. Indexed by y * width + x
+	std::vector<unsigned char> costs; ///< Cost of stepping onto the tile, 1 unless raised with set_tile_cost
+	int version = 0; ///< Bumped on every wall or cost change, so cached searches know when to rebuild
 
 	SquareGrid(int width_, int height_)
-		: width(width_), height(height_) {}
+		: width(width_), height(height_), walls(width_ * height_, 0), costs(width_ * height_, 1) {}
+
+	inline int index(int x, int y) const {
+		return y * width + x;
+	}
+
+	inline void add_wall(Location id) {
+		int x, y;
+		std::tie(x, y) = id;
+		walls[index(x, y)] = 1;
+		version++;
+	}
+
+	inline void remove_wall(Location id) {
+		int x, y;
+		std::tie(x, y) = id;
+		walls[index(x, y)] = 0;
+		version++;
+	}
+
+	inline void clear_walls() {
+		std::fill(walls.begin(), walls.end(), 0);
+		version++;
+	}
+
+	//Expects in_bounds(id) and 1 <= cost <= 255
+	inline void set_tile_cost(Location id, int cost) {
+		int x, y;
+		std::tie(x, y) = id;
+		costs[index(x, y)] = (unsigned char)cost;
+		version++;
+	}
+
+	inline void clear_costs() {
+		std::fill(costs.begin(), costs.end(), 1);
+		version++;
+	}
 
 	inline bool in_bounds(Location id) const {
 		int x, y;
@@ -70,33 +110,45 @@ struct SquareGrid {
 		return 0 <= x && x < width && 0 <= y && y < height;
 	}
 
+	//Expects in_bounds(id)
 	inline bool passable(Location id) const {
-		return !walls.count(id);
+		int x, y;
+		std::tie(x, y) = id;
+		return walls[index(x, y)] == 0;
 	}
 
+	//Expects in_bounds(id)
+	inline int tile_cost(Location id) const {
+		int x, y;
+		std::tie(x, y) = id;
+		return costs[index(x, y)];
+	}
+
+	//Of the step from a onto its neighbor b
 	inline int cost(Location a, Location b) const {
-		return 1;
+		return tile_cost(b);
 	}
 
-	std::vector<Location> neighbors(Location id) const {
+	//Writes the passable neighbors of id into results and returns how many there are
+	int neighbors(Location id, Neighbors& results) const {
 		int x, y, dx, dy;
 		std::tie(x, y) = id;
-		std::vector<Location> results;
+		int numResults = 0;
 
 		for (auto dir : DIRS2) {
 			std::tie(dx, dy) = dir;
 			Location next(x + dx, y + dy);
 			if (in_bounds(next) && passable(next)) {
-				results.push_back(next);
+				results[numResults++] = next;
 			}
 		}
 
 		if ((x + y) % 2 == 0) {
 			// aesthetic improvement on square grids
-			std::reverse(results.begin(), results.end());
+			std::reverse(results.begin(), results.begin() + numResults);
 		}
 
-		return results;
+		return numResults;
 	}
 };
 
@@ -158,5 +210,30 @@ public:
 		std::unordered_map<SquareGrid::Location, SquareGrid::Location>* point_to = nullptr,
 		std::vector<SquareGrid::Location>* path = nullptr);
 
+	/// Same search as a_star_search + reconstruct_path2, but on flat arrays owned by the PathFinder.
+	/// The arrays are stamped with a generation counter, so repeated searches neither clear nor allocate.
+	/// Writes the tiles from start to goal into path and returns false (empty path) if goal can't be reached
+	/// Monsters follow the FlowField of their player, the path finder benchmark keeps this as its single-target reference
+	bool find_path(const SquareGrid& squareGrid, SquareGrid::Location start, SquareGrid::Location goal, std::vector<glm::vec2>& path);
+
+private:
+	struct OpenNode {
+		int priority;
+		int cell; ///< x * height + y, so ties are broken like the tuple locations in a_star_search
+
+		bool operator>(const OpenNode& other) const {
+			return priority > other.priority || (priority == other.priority && cell > other.cell);
+		}
+	};
+
+	void prepareSearch(const SquareGrid& squareGrid);
+
+	int m_width = 0;
+	int m_height = 0;
+	unsigned int m_generation = 0;
+	std::vector<unsigned int> m_visited; ///< Generation in which a cell got a cost
+	std::vector<int> m_cost;
+	std::vector<int> m_parent;
+	std::vector<OpenNode> m_open; ///< Binary min heap, keeps its capacity between searches
 };
 
@@ -0,0 +1,254 @@
+#include "PathFinderBenchmark.h"
+#include "Level.h"
+#include "PathFinder.h"
+
+#include <GameEngine\IOManager.h>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+const int SEARCHES_PER_LEVEL = 1000;
+const int TIMED_RUNS = 20;
+const unsigned int BENCHMARK_SEED = 1337;
+
+//SquareGrid as it was before the walls moved into a byte grid and neighbors into a fixed array
+struct OldSquareGrid {
+	typedef std::tuple<int, int> Location;
+
+	int width, height;
+	std::unordered_set<Location> walls;
+
+	OldSquareGrid(int width_, int height_)
+		: width(width_), height(height_) {}
+
+	inline bool in_bounds(Location id) const {
+		int x, y;
+		std::tie(x, y) = id;
+		return 0 <= x && x < width && 0 <= y && y < height;
+	}
+
+	inline bool passable(Location id) const {
+		return !walls.count(id);
+	}
+
+	inline int cost(Location a, Location b) const {
+		return 1;
+	}
+
+	std::vector<Location> neighbors(Location id) const {
+		int x, y, dx, dy;
+		std::tie(x, y) = id;
+		std::vector<Location> results;
+
+		for (auto dir : SquareGrid::DIRS2) {
+			std::tie(dx, dy) = dir;
+			Location next(x + dx, y + dy);
+			if (in_bounds(next) && passable(next)) {
+				results.push_back(next);
+			}
+		}
+
+		if ((x + y) % 2 == 0) {
+			// aesthetic improvement on square grids
+			std::reverse(results.begin(), results.end());
+		}
+
+		return results;
+	}
+};
+
+static int heuristic(SquareGrid::Location a, SquareGrid::Location b){
+	int x1, y1, x2, y2;
+	std::tie(x1, y1) = a;
+	std::tie(x2, y2) = b;
+	return abs(x1 - x2) + abs(y1 - y2);
+}
+
+//PathFinder::a_star_search with both neighbor interfaces, returns the number of expanded nodes
+static int searchOld(const OldSquareGrid& grid, SquareGrid::Location start, SquareGrid::Location goal, int& pathCost){
+	PriorityQueue<SquareGrid::Location> frontier;
+	unordered_map<SquareGrid::Location, int> cost_so_far;
+	frontier.put(start, 0);
+	cost_so_far[start] = 0;
+
+	int numExpanded = 0;
+	while (!frontier.empty()) {
+		auto current = frontier.get();
+		if (current == goal) {
+			break;
+		}
+		numExpanded++;
+
+		for (auto next : grid.neighbors(current)) {
+			int new_cost = cost_so_far[current] + grid.cost(current, next);
+			if (!cost_so_far.count(next) || new_cost < cost_so_far[next]) {
+				cost_so_far[next] = new_cost;
+				frontier.put(next, new_cost + heuristic(next, goal));
+			}
+		}
+	}
+
+	pathCost = cost_so_far.count(goal) ? cost_so_far[goal] : -1;
+	return numExpanded;
+}
+
+static int searchNew(const SquareGrid& grid, SquareGrid::Location start, SquareGrid::Location goal, int& pathCost){
+	PriorityQueue<SquareGrid::Location> frontier;
+	unordered_map<SquareGrid::Location, int> cost_so_far;
+	frontier.put(start, 0);
+	cost_so_far[start] = 0;
+
+	int numExpanded = 0;
+	SquareGrid::Neighbors neighbors;
+	while (!frontier.empty()) {
+		auto current = frontier.get();
+		if (current == goal) {
+			break;
+		}
+		numExpanded++;
+
+		int numNeighbors = grid.neighbors(current, neighbors);
+		for (int i = 0; i < numNeighbors; i++) {
+			const SquareGrid::Location& next = neighbors[i];
+			int new_cost = cost_so_far[current] + grid.cost(current, next);
+			if (!cost_so_far.count(next) || new_cost < cost_so_far[next]) {
+				cost_so_far[next] = new_cost;
+				frontier.put(next, new_cost + heuristic(next, goal));
+			}
+		}
+	}
+
+	pathCost = cost_so_far.count(goal) ? cost_so_far[goal] : -1;
+	return numExpanded;
+}
+
+//Runs PathFinder::find_path and returns the cost of the path it found, -1 if there is none
+static int searchFlat(PathFinder& pathFinder, const SquareGrid& grid, SquareGrid::Location start, SquareGrid::Location goal, std::vector<glm::vec2>& path){
+	if (!pathFinder.find_path(grid, start, goal, path))
+	{
+		return -1;
+	}
+
+	int pathCost = 0;
+	for (size_t i = 1; i < path.size(); i++)
+	{
+		pathCost += grid.tile_cost(SquareGrid::Location((int)path[i].x, (int)path[i].y));
+	}
+	return pathCost;
+}
+
+//Reads the tiles of a level file like the Level constructor, false if there is no such file
+static bool loadLevelData(const std::string& fileName, std::vector<std::string>& levelData){
+	GameEngine::FileView file;
+	if (!file.open(fileName))
+	{
+		return false;
+	}
+
+	//The first line holds the number of humans
+	size_t position = 0;
+	std::string line;
+	file.getLine(position, line);
+
+	levelData.clear();
+	while (file.getLine(position, line)){
+		levelData.push_back(line);
+	}
+	return !levelData.empty();
+}
+
+void runPathFinderBenchmark(){
+	for (int levelNumber = 1;; levelNumber++)
+	{
+		std::string fileName = "Levels/level" + std::to_string(levelNumber) + ".txt";
+		std::vector<std::string> levelData;
+		if (!loadLevelData(fileName, levelData))
+		{
+			if (levelNumber == 1)
+			{
+				printf("No levels found, run the benchmark in the SpacePanic directory\n");
+			}
+			break;
+		}
+
+		SquareGrid grid(levelData[0].size(), levelData.size());
+		Level::addWalls(levelData, grid);
+
+		OldSquareGrid oldGrid(grid.width, grid.height);
+		std::vector<SquareGrid::Location> walkable;
+		for (int y = 0; y < grid.height; y++)
+		{
+			for (int x = 0; x < grid.width; x++)
+			{
+				SquareGrid::Location tile(x, y);
+				if (grid.passable(tile))
+				{
+					walkable.push_back(tile);
+				}
+				else
+				{
+					oldGrid.walls.insert(tile);
+				}
+			}
+		}
+		if (walkable.empty())
+		{
+			continue;
+		}
+
+		//Same pairs for both grids
+		std::mt19937 randomEngine(BENCHMARK_SEED);
+		std::uniform_int_distribution<int> randTile(0, (int)walkable.size() - 1);
+		std::vector<std::pair<SquareGrid::Location, SquareGrid::Location>> searches;
+		for (int i = 0; i < SEARCHES_PER_LEVEL; i++)
+		{
+			searches.emplace_back(walkable[randTile(randomEngine)], walkable[randTile(randomEngine)]);
+		}
+
+		PathFinder pathFinder;
+		std::vector<glm::vec2> path;
+
+		long long oldExpanded = 0, newExpanded = 0;
+		long long oldCost = 0, newCost = 0, flatCost = 0;
+		double oldSeconds = 0.0, newSeconds = 0.0, flatSeconds = 0.0;
+		for (int run = 0; run < TIMED_RUNS; run++)
+		{
+			auto start = std::chrono::high_resolution_clock::now();
+			for (auto& search : searches)
+			{
+				int pathCost;
+				oldExpanded += searchOld(oldGrid, search.first, search.second, pathCost);
+				oldCost += pathCost;
+			}
+			auto middle = std::chrono::high_resolution_clock::now();
+			for (auto& search : searches)
+			{
+				int pathCost;
+				newExpanded += searchNew(grid, search.first, search.second, pathCost);
+				newCost += pathCost;
+			}
+			auto end = std::chrono::high_resolution_clock::now();
+			for (auto& search : searches)
+			{
+				flatCost += searchFlat(pathFinder, grid, search.first, search.second, path);
+			}
+			auto flatEnd = std::chrono::high_resolution_clock::now();
+
+			oldSeconds += std::chrono::duration<double>(middle - start).count();
+			newSeconds += std::chrono::duration<double>(end - middle).count();
+			flatSeconds += std::chrono::duration<double>(flatEnd - end).count();
+		}
+
+		double oldRate = oldExpanded / oldSeconds / 1000000.0;
+		double newRate = newExpanded / newSeconds / 1000000.0;
+		//find_path doesn't count its expansions, so its rate uses the count of the same searches in searchNew
+		double flatRate = newExpanded / flatSeconds / 1000000.0;
+		printf("%-20s %4dx%-3d  %9lld expansions  before %6.2f M/s  after %6.2f M/s  %5.2fx  find_path %6.2f M/s  %5.2fx  %s\n",
+			fileName.c_str(), grid.width, grid.height, newExpanded / TIMED_RUNS, oldRate, newRate, newRate / oldRate,
+			flatRate, flatRate / oldRate,
+			oldExpanded == newExpanded && oldCost == newCost && flatCost == newCost ? "same paths" : "PATHS DIFFER");
+	}
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+/// Headless timing of the monster A*, started with "SpacePanic.exe --benchmark". Loads the walls of every
+/// Levels/level*.txt and searches between random pairs of walkable tiles, once on the SquareGrid as it was
+/// before the dense wall grid (walls in an unordered_set, neighbors returned in a new vector) and once on the
+/// current SquareGrid. Both run the same a_star_search, so they expand the same nodes and must find paths
+/// of the same length. PathFinder::find_path runs the same searches on the current SquareGrid as well.
+/// Prints the node expansions per second of all three
+void runPathFinderBenchmark();
@@ -24,7 +24,7 @@ void Player::init(GameEngine::InputManager* inputManager, const glm::vec2 positi
 	m_health = 3;
 
 	//Load the texture
-	GameEngine::GLTexture texture = GameEngine::ResourceManager::getTexture(textureFilePath);
+	GameEngine::GLTexture texture = GameEngine::ResourceManager::getAtlasTextureAsync(textureFilePath);
 
 	m_collisionBox.init(position, collisionDims, &texture, color, glm::vec4(0.0f, 0.0f, 0.1f, 0.5f));
 
@@ -102,10 +102,15 @@ void Player::update(Level& level, std::vector<Player*>& players, std::vector<Mon
 
 
 
-bool Player::collideWithHalfHole(std::vector<Box>& levelBoxes){
+bool Player::collideWithHalfHole(BoxGrid& halfHoleBoxes){
 
-	for (auto box : levelBoxes)
+	//Also look one tile below the agent, the box above a hole counts too
+	glm::vec2 queryPosition(m_collisionBox.m_position.x, m_collisionBox.m_position.y - TILE_WIDTH);
+	glm::vec2 queryDimensions(m_collisionBox.m_dimensions.x, m_collisionBox.m_dimensions.y + TILE_WIDTH);
+
+	for (int index : halfHoleBoxes.query(queryPosition, queryDimensions))
 	{
+		Box& box = halfHoleBoxes[index];
 		glm::vec4 penetrationDepth;
 		if (collideWithBox(&box, penetrationDepth) == true)
 		{
@@ -126,10 +131,15 @@ bool Player::collideWithHalfHole(std::vector<Box>& levelBoxes){
 	return false;
 }
 
-bool Player::collideWithHole(std::vector<Box>& levelBoxes){
+bool Player::collideWithHole(BoxGrid& holeBoxes){
 	//may fall?
-	for (auto box : levelBoxes)
+	//Also look one tile below the agent, the box above a hole counts too
+	glm::vec2 queryPosition(m_collisionBox.m_position.x, m_collisionBox.m_position.y - TILE_WIDTH);
+	glm::vec2 queryDimensions(m_collisionBox.m_dimensions.x, m_collisionBox.m_dimensions.y + TILE_WIDTH);
+
+	for (int index : holeBoxes.query(queryPosition, queryDimensions))
 	{
+		Box& box = holeBoxes[index];
 		glm::vec4 penetrationDepth;
 		if (collideWithBox(&box, penetrationDepth) == true)
 		{
@@ -154,7 +164,7 @@ bool Player::collideWithHole(std::vector<Box>& levelBoxes){
 
 
 
-void Player::draw(GameEngine::SpriteBatch& spriteBatch){
+void Player::draw(GameEngine::SpriteBatch& spriteBatch, float alpha){
 	glm::vec4 uvRect;
 
 	int tileIndex;
@@ -220,9 +230,9 @@ void Player::draw(GameEngine::SpriteBatch& spriteBatch){
 		tileIndex = 19;
 	}
 
-	//Increment animation time
-	//TODO: add deltaTime
-	m_animTime += animSpeed;
+	//Increment animation time by the ticks since the last draw
+	m_animTime += animSpeed * m_animFrames;
+	m_animFrames = 0.0f;
 
 	//Check for digging end
 	if (m_animTime > numTiles)
@@ -239,12 +249,18 @@ void Player::draw(GameEngine::SpriteBatch& spriteBatch){
 	//Check direction
 	if (m_direction == glm::vec2(-1.0f, 0.0f))
 	{
-		uvRect.x += 1.0f / m_collisionBox.m_texture.dims.x;
+		uvRect.x += uvRect.z;
 		uvRect.z *= -1;
 	}
 
 	m_collisionBox.setUVRect(uvRect);
-	m_collisionBox.draw(spriteBatch);
+
+	//Move the box to the interpolated position
+	glm::vec4 destRect = m_collisionBox.getDestRect();
+	glm::vec2 offset = getDrawPosition(alpha) - m_collisionBox.getPosition();
+	destRect.x += offset.x;
+	destRect.y += offset.y;
+	m_collisionBox.draw(spriteBatch, destRect);
 }
 
 void Player::kill(){
@@ -336,10 +352,10 @@ void Player::updateActions(Level& level, std::vector<Player*>& players, std::vec
 }
 
 bool Player::tryDigging(Level& level, std::vector<Player*>& players, std::vector<Monster*>& monsters, Box& groundBox){
-	std::vector<Box>& levelBoxes = level.getLevelBoxes();
-	std::vector<Box>& ladderBoxes = level.getLadderBoxes();
-	std::vector<Box>& halfHoleBoxes = level.getHalfHoleBoxes();
-	std::vector<Box>& holeBoxes = level.getHoleBoxes();
+	BoxGrid& levelBoxes = level.getLevelBoxes();
+	BoxGrid& ladderBoxes = level.getLadderBoxes();
+	BoxGrid& halfHoleBoxes = level.getHalfHoleBoxes();
+	BoxGrid& holeBoxes = level.getHoleBoxes();
 
 	if (m_direction == glm::vec2(-1.0f, 0.0f)) // links
 	{
@@ -392,14 +408,14 @@ bool Player::tryDigging(Level& level, std::vector<Player*>& players, std::vector
 
 				if (monsterIsInHole == false)
 				{
-					holeBoxes[i] = holeBoxes.back();
-					holeBoxes.pop_back();
+					holeBoxes.remove(i);
 
 					groundBox.m_color = GameEngine::ColorRGBA8(0, 255, 255, 255);
-					groundBox.m_textureID = GameEngine::ResourceManager::getTexture("Textures/red_bricks.png").id;
-					groundBox.m_texture.texture = GameEngine::ResourceManager::getTexture("Textures/red_bricks.png");
+					groundBox.setTexture(GameEngine::ResourceManager::getAtlasTextureAsync("Textures/red_bricks.png"));
 
-					levelBoxes.push_back(groundBox);
+					levelBoxes.add(groundBox);
+					level.updateTile(groundBox);
+					level.setHoleOpen(groundBox, false);
 					playCloseHoleSound();
 				}
 
@@ -427,13 +443,13 @@ bool Player::tryDigging(Level& level, std::vector<Player*>& players, std::vector
 
 				if (monsterIsInHole == false)
 				{
-					halfHoleBoxes[i] = halfHoleBoxes.back();
-					halfHoleBoxes.pop_back();
+					halfHoleBoxes.remove(i);
 
 					groundBox.m_color = GameEngine::ColorRGBA8(255, 0, 0, 0);
-					groundBox.m_textureID = GameEngine::ResourceManager::getTexture("Textures/red_bricks.png").id;
-					groundBox.m_texture.texture = GameEngine::ResourceManager::getTexture("Textures/red_bricks.png");
-					holeBoxes.push_back(groundBox);
+					groundBox.setTexture(GameEngine::ResourceManager::getAtlasTextureAsync("Textures/red_bricks.png"));
+					holeBoxes.add(groundBox);
+					level.updateTile(groundBox);
+					level.setHoleOpen(groundBox, true);
 					playDiggingSound();
 				}
 
@@ -460,8 +476,7 @@ bool Player::tryDigging(Level& level, std::vector<Player*>& players, std::vector
 				{
 					groundBox = levelBoxes[i];
 					foundGroundBox = true;
-					levelBoxes[i] = levelBoxes.back();
-					levelBoxes.pop_back();
+					levelBoxes.remove(i);
 				}
 				else{
 					i++;
@@ -470,13 +485,14 @@ bool Player::tryDigging(Level& level, std::vector<Player*>& players, std::vector
 
 			if (wallAboveGround == true){
 				foundGroundBox = false;
-				levelBoxes.push_back(groundBox); // add groundBox back to level boxes
+				levelBoxes.add(groundBox); // add groundBox back to level boxes
 			}
 			else if (foundGroundBox == true)
 			{
 				groundBox.m_color = GameEngine::ColorRGBA8(0, 80, 128, 255);
-				groundBox.m_textureID = GameEngine::ResourceManager::getTexture("Textures/light_bricks.png").id;
-				halfHoleBoxes.push_back(groundBox);
+				groundBox.setTexture(GameEngine::ResourceManager::getAtlasTextureAsync("Textures/light_bricks.png"));
+				halfHoleBoxes.add(groundBox);
+				level.updateTile(groundBox);
 				playDiggingSound();
 			}
 		}
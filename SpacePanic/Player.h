@@ -26,10 +26,10 @@ public:
 	virtual void update(std::vector<Box>& levelBoxes, std::vector<Player*>& players, std::vector<Monster*>& monsters, float deltaTime) override;
 	virtual void update(Level& level, std::vector<Player*>& players, std::vector<Monster*>& monsters, float deltaTime) override;
 
-	virtual bool collideWithHalfHole(std::vector<Box>& levelBoxes) override;
-	virtual bool collideWithHole(std::vector<Box>& levelBoxes) override;
+	virtual bool collideWithHalfHole(BoxGrid& halfHoleBoxes) override;
+	virtual bool collideWithHole(BoxGrid& holeBoxes) override;
 
-	void draw(GameEngine::SpriteBatch& spriteBatch);
+	void draw(GameEngine::SpriteBatch& spriteBatch, float alpha);
 
 	void kill();
 
@@ -25,70 +25,79 @@ void Agent::draw(GameEngine::SpriteBatch& spriteBatch){
 
 
 bool Agent::collideWithLevel(const std::vector<std::string>& levelData){
-	std::vector<glm::vec2> collideTilePositions;
+	return collideWithLevel(levelData, m_position);
+}
+
+//circular collision
+bool Agent::collideWithAgent(Agent* agent){
+	return collideAgents(m_position, agent->m_position);
+}
+
+bool Agent::collideWithLevel(const std::vector<std::string>& levelData, glm::vec2& position){
+	glm::vec2 collideTilePositions[4];
+	int numCollideTiles = 0;
 
 	//Check the four corners
 	//First corner
 	checkTilePosition(levelData,
-		collideTilePositions,
-		m_position.x,
-		m_position.y);
+		collideTilePositions, numCollideTiles,
+		position.x,
+		position.y);
 
 	//Second corner
 	checkTilePosition(levelData,
-		collideTilePositions,
-		m_position.x + AGENT_WIDTH,
-		m_position.y);
+		collideTilePositions, numCollideTiles,
+		position.x + AGENT_WIDTH,
+		position.y);
 
 	//Third corner
 	checkTilePosition(levelData,
-		collideTilePositions,
-		m_position.x,
-		m_position.y + AGENT_WIDTH);
+		collideTilePositions, numCollideTiles,
+		position.x,
+		position.y + AGENT_WIDTH);
 
 	//Fourth corner
 	checkTilePosition(levelData,
-		collideTilePositions,
-		m_position.x + AGENT_WIDTH,
-		m_position.y + AGENT_WIDTH);
+		collideTilePositions, numCollideTiles,
+		position.x + AGENT_WIDTH,
+		position.y + AGENT_WIDTH);
 
-	if (collideTilePositions.size() == 0)
+	if (numCollideTiles == 0)
 	{
 		return false;
 	}
 
 	//Do the collision
-	for (int i = 0; i < collideTilePositions.size(); i++)
+	for (int i = 0; i < numCollideTiles; i++)
 	{
-		collideWithTile(collideTilePositions[i]);
+		collideWithTile(position, collideTilePositions[i]);
 	}
 
 	return true;
 }
 
-//circular collision
-bool Agent::collideWithAgent(Agent* agent){
+bool Agent::collideAgents(glm::vec2& positionA, glm::vec2& positionB){
 
 	// Is the Agent too far away in the X direction to check?
-	if (agent->m_position.x < m_position.x - AGENT_WIDTH) { 
+	if (positionB.x < positionA.x - AGENT_WIDTH) { 
 		return false; 
 	}
-	else if (agent->m_position.x > m_position.x + AGENT_WIDTH) { 
+	else if (positionB.x > positionA.x + AGENT_WIDTH) { 
 		return false; 
 	}
 
 	// Is the Agent too far away in the Y direction to check?
-	if (agent->m_position.y < m_position.y - AGENT_WIDTH)      { 
+	if (positionB.y < positionA.y - AGENT_WIDTH)      { 
 		return false; 
 	}
-	else if (agent->m_position.y > m_position.y + AGENT_WIDTH) { 
+	else if (positionB.y > positionA.y + AGENT_WIDTH) { 
 		return false; 
 	}
 
 	const float MIN_DISTANCE = AGENT_RADIUS * 2.0f;
 
-	glm::vec2 centerPosA = m_position + glm::vec2(AGENT_RADIUS);
-	glm::vec2 centerPosB = agent->getPosition() + glm::vec2(AGENT_RADIUS);
+	glm::vec2 centerPosA = positionA + glm::vec2(AGENT_RADIUS);
+	glm::vec2 centerPosB = positionB + glm::vec2(AGENT_RADIUS);
 
 	glm::vec2 distVec = centerPosA - centerPosB;
 
@@ -99,8 +108,8 @@ bool Agent::collideWithAgent(Agent* agent){
 	if (collisionDepth > 0)
 	{
 		glm::vec2 collisionDepthVec = glm::normalize(distVec) * collisionDepth;
-		m_position += collisionDepthVec / 2.0f;
-		agent->m_position -= collisionDepthVec / 2.0f;
+		positionA += collisionDepthVec / 2.0f;
+		positionB -= collisionDepthVec / 2.0f;
 		return true;
 	}
 
@@ -121,7 +130,7 @@ bool Agent::applyDamage(float damage){
 }
 
 
-void Agent::checkTilePosition(const std::vector<std::string>& levelData, std::vector<glm::vec2>& collideTilePositions, float x, float y){
+void Agent::checkTilePosition(const std::vector<std::string>& levelData, glm::vec2* collideTilePositions, int& numCollideTiles, float x, float y){
 
 	glm::vec2 cornerPos = glm::vec2(floor(x / (float)TILE_WIDTH),
 		floor(y / (float)TILE_WIDTH));
@@ -132,32 +141,32 @@ void Agent::checkTilePosition(const std::vector<std::string>& levelData, std::ve
 	}
 
 	if (levelData[cornerPos.y][cornerPos.x] != '.'){
-		collideTilePositions.push_back(cornerPos * (float)TILE_WIDTH + glm::vec2((float)TILE_WIDTH / 2.0f));
+		collideTilePositions[numCollideTiles++] = cornerPos * (float)TILE_WIDTH + glm::vec2((float)TILE_WIDTH / 2.0f);
 	}
 }
 
 
 // AABB collision (Axis Aligned Bounding Box)
-bool Agent::collideWithTile(glm::vec2 tilePosition){
+bool Agent::collideWithTile(glm::vec2& position, glm::vec2 tilePosition){
 
 	// Is the tile too far away
-	if (tilePosition.x < m_position.x - TILE_WIDTH) {
+	if (tilePosition.x < position.x - TILE_WIDTH) {
 		return false;
 	}
-	else if (tilePosition.x > m_position.x + TILE_WIDTH) {
+	else if (tilePosition.x > position.x + TILE_WIDTH) {
 		return false;
 	}
-	if (tilePosition.y < m_position.y - TILE_WIDTH) {
+	if (tilePosition.y < position.y - TILE_WIDTH) {
 		return false;
 	}
-	else if (tilePosition.y > m_position.y + TILE_WIDTH) {
+	else if (tilePosition.y > position.y + TILE_WIDTH) {
 		return false;
 	}
 
 	const float TILE_RADIUS = (float)TILE_WIDTH / 2.0f;
 	const float MIN_DISTANCE = AGENT_RADIUS + TILE_RADIUS;
 
-	glm::vec2 centerPlayerPos = m_position + glm::vec2(AGENT_RADIUS);
+	glm::vec2 centerPlayerPos = position + glm::vec2(AGENT_RADIUS);
 	glm::vec2 distanceVec = centerPlayerPos - tilePosition;
 
 	float xDepth = MIN_DISTANCE - abs(distanceVec.x);
@@ -168,22 +177,25 @@ bool Agent::collideWithTile(glm::vec2 tilePosition){
 		if (std::max(xDepth, 0.0f) < std::max(yDepth, 0.0f)){
 			if (distanceVec.x < 0)
 			{
-				m_position.x -= xDepth;
+				position.x -= xDepth;
 			}
 			else
 			{
-				m_position.x += xDepth;
+				position.x += xDepth;
 			}
 		}
 		else{
 			if (distanceVec.y < 0)
 			{
-				m_position.y -= yDepth;
+				position.y -= yDepth;
 			}
 			else
 			{
-				m_position.y += yDepth;
+				position.y += yDepth;
 			}
 		}
+		return true;
 	}
+
+	return false;
 }
\ No newline at end of file
@@ -8,9 +8,6 @@
 const float AGENT_WIDTH = 60;
 const float AGENT_RADIUS = AGENT_WIDTH / 2.0f;
 
-class Zombie;
-class Human;
-
 class Agent
 {
 public:
@@ -25,15 +22,19 @@ public:
 
 	void draw(GameEngine::SpriteBatch& spriteBatch);
 
-	virtual void update(const std::vector<std::string>& levelData,
-		std::vector<Human*>& humans, std::vector<Zombie*>& zombies, float deltaTime) = 0;
+	virtual void update(const std::vector<std::string>& levelData, float deltaTime) = 0;
 
 	glm::vec2 getPosition() const { return m_position; }
+	void setPosition(const glm::vec2& position) { m_position = position; }
 
 	bool collideWithLevel(const std::vector<std::string>& levelData);
 
 	bool collideWithAgent(Agent* agent);
 
+	//The same collisions on plain positions, the AgentStore runs them on its columns
+	static bool collideWithLevel(const std::vector<std::string>& levelData, glm::vec2& position);
+	static bool collideAgents(glm::vec2& positionA, glm::vec2& positionB);
+
 	//Return true if health is zero or less --> agent died
 	bool applyDamage(float damage);
 
@@ -48,11 +49,12 @@ public:
 
 protected:
 
-	void checkTilePosition(const std::vector<std::string>& levelData,
-		std::vector<glm::vec2>& collideTilePosition,
+	//At most one tile per corner, so collideTilePositions needs room for four
+	static void checkTilePosition(const std::vector<std::string>& levelData,
+		glm::vec2* collideTilePositions, int& numCollideTiles,
 		float x, float y);
 
-	bool collideWithTile(glm::vec2 tilePosition);
+	static bool collideWithTile(glm::vec2& position, glm::vec2 tilePosition);
 
 	glm::vec2 m_position;
 	glm::vec2 m_direction = glm::vec2(1.0f, 0.0f);
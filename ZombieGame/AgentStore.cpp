@@ -0,0 +1,257 @@
+#include "AgentStore.h"
+#include "Agent.h"
+
+#include <GameEngine\ResourceManager.h>
+#include <GameEngine\Profiler.h>
+#include <glm\gtx\rotate_vector.hpp>
+#include <ctime>
+#include <limits>
+
+const float DEG_TO_RAD = M_PI / 180.0f;
+
+const int HUMAN_TURN_FRAMES = 20; ///< Humans pick a new direction after this many frames
+
+//Xorshift, returns a number in [0, 1)
+static float nextRandom(unsigned int& state){
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return (state >> 8) * (1.0f / 16777216.0f);
+}
+
+
+AgentStore::AgentStore() : m_randomEngine(time(nullptr))
+{
+}
+
+
+AgentStore::~AgentStore()
+{
+}
+
+void AgentStore::init(){
+	m_humanTextureID = GameEngine::ResourceManager::getTexture("Textures/human.png").id;
+	m_zombieTextureID = GameEngine::ResourceManager::getTexture("Textures/zombie.png").id;
+}
+
+void AgentStore::clear(){
+	m_positionsX.clear();
+	m_positionsY.clear();
+	m_directionsX.clear();
+	m_directionsY.clear();
+	m_speeds.clear();
+	m_health.clear();
+	m_kinds.clear();
+	m_frames.clear();
+	m_hitWall.clear();
+	m_randomStates.clear();
+	m_numHumans = 0;
+}
+
+void AgentStore::seed(unsigned int seed){
+	m_randomEngine.seed(seed);
+}
+
+int AgentStore::addHuman(const glm::vec2& position, float speed, float health){
+	std::uniform_real_distribution<float> randDir(-1.0f, 1.0f);
+
+	//Get random direction
+	glm::vec2 direction(randDir(m_randomEngine), randDir(m_randomEngine));
+
+	//Make sure direction isn't zero
+	if (direction == glm::vec2(0.0f)){
+		direction = glm::vec2(1.0f, 0.0f);
+	}
+
+	m_numHumans++;
+	return add(AgentKind::HUMAN, position, glm::normalize(direction), speed, health);
+}
+
+int AgentStore::addZombie(const glm::vec2& position, float speed, float health){
+	return add(AgentKind::ZOMBIE, position, glm::vec2(1.0f, 0.0f), speed, health);
+}
+
+void AgentStore::infect(int index, float speed, float health){
+	if (m_kinds[index] == AgentKind::HUMAN)
+	{
+		m_numHumans--;
+	}
+	m_kinds[index] = AgentKind::ZOMBIE;
+	m_speeds[index] = speed;
+	m_health[index] = health;
+}
+
+void AgentStore::remove(int index){
+	if (m_kinds[index] == AgentKind::HUMAN)
+	{
+		m_numHumans--;
+	}
+
+	int last = m_kinds.size() - 1;
+	m_positionsX[index] = m_positionsX[last];
+	m_positionsY[index] = m_positionsY[last];
+	m_directionsX[index] = m_directionsX[last];
+	m_directionsY[index] = m_directionsY[last];
+	m_speeds[index] = m_speeds[last];
+	m_health[index] = m_health[last];
+	m_kinds[index] = m_kinds[last];
+	m_frames[index] = m_frames[last];
+	m_hitWall[index] = m_hitWall[last];
+	m_randomStates[index] = m_randomStates[last];
+
+	m_positionsX.pop_back();
+	m_positionsY.pop_back();
+	m_directionsX.pop_back();
+	m_directionsY.pop_back();
+	m_speeds.pop_back();
+	m_health.pop_back();
+	m_kinds.pop_back();
+	m_frames.pop_back();
+	m_hitWall.pop_back();
+	m_randomStates.pop_back();
+}
+
+bool AgentStore::applyDamage(int index, float damage){
+	m_health[index] -= damage;
+
+	return m_health[index] <= 0.0f;
+}
+
+void AgentStore::updateHumans(const std::vector<std::string>& levelData, float deltaTime, int begin, int end){
+	PROFILE_ZONE("AgentStore::updateHumans");
+
+	const float MAX_TURN = 40.0f * DEG_TO_RAD;
+
+	move(AgentKind::HUMAN, deltaTime, begin, end);
+
+	collideWithLevel(AgentKind::HUMAN, levelData, begin, end);
+
+	for (int i = begin; i < end; i++)
+	{
+		if (m_kinds[i] != AgentKind::HUMAN)
+		{
+			continue;
+		}
+
+		glm::vec2 direction(m_directionsX[i], m_directionsY[i]);
+
+		//Randomly change direction every few frames
+		if (m_frames[i] == HUMAN_TURN_FRAMES)
+		{
+			direction = glm::rotate(direction, (nextRandom(m_randomStates[i]) * 2.0f - 1.0f) * MAX_TURN);
+			m_frames[i] = 0;
+		}
+		else
+		{
+			m_frames[i]++;
+		}
+
+		//And whenever we ran into a wall
+		if (m_hitWall[i])
+		{
+			direction = glm::rotate(direction, (nextRandom(m_randomStates[i]) * 2.0f - 1.0f) * MAX_TURN);
+		}
+
+		m_directionsX[i] = direction.x;
+		m_directionsY[i] = direction.y;
+	}
+}
+
+void AgentStore::updateZombies(const std::vector<std::string>& levelData, const GameEngine::SpatialGrid& targetGrid, float deltaTime, int begin, int end){
+	PROFILE_ZONE("AgentStore::updateZombies");
+
+	//Head for the nearest target, a zombie without one keeps its direction
+	for (int i = begin; i < end; i++)
+	{
+		if (m_kinds[i] != AgentKind::ZOMBIE)
+		{
+			continue;
+		}
+
+		glm::vec2 center(m_positionsX[i] + AGENT_RADIUS, m_positionsY[i] + AGENT_RADIUS);
+		int target = targetGrid.findNearest(center, std::numeric_limits<float>::max());
+		if (target != -1)
+		{
+			const glm::vec4& box = targetGrid.getBox(target);
+			glm::vec2 direction = glm::normalize(glm::vec2(box.x + box.z * 0.5f, box.y + box.w * 0.5f) - center);
+			m_directionsX[i] = direction.x;
+			m_directionsY[i] = direction.y;
+		}
+	}
+
+	move(AgentKind::ZOMBIE, deltaTime, begin, end);
+
+	collideWithLevel(AgentKind::ZOMBIE, levelData, begin, end);
+}
+
+void AgentStore::moveBy(int index, const glm::vec2& offset){
+	m_positionsX[index] += offset.x;
+	m_positionsY[index] += offset.y;
+}
+
+void AgentStore::draw(GameEngine::SpriteBatch& spriteBatch, GameEngine::Camera2D& camera){
+	const glm::vec2 agentDims(AGENT_RADIUS * 2.0f);
+	const glm::vec4 uvRect(0.0f, 0.0f, 1.0f, 1.0f);
+	const GameEngine::ColorRGBA8 color(255, 255, 255, 255);
+
+	for (int i = 0; i < size(); i++)
+	{
+		glm::vec2 position = getPosition(i);
+		if (camera.isBoxInView(position, agentDims))
+		{
+			glm::vec4 destRect(position.x, position.y, AGENT_WIDTH, AGENT_WIDTH);
+			glm::vec2 direction(m_directionsX[i], m_directionsY[i]);
+			GLuint textureID = m_kinds[i] == AgentKind::HUMAN ? m_humanTextureID : m_zombieTextureID;
+
+			spriteBatch.draw(destRect, uvRect, textureID, 0.0f, color, direction);
+		}
+	}
+}
+
+int AgentStore::add(AgentKind kind, const glm::vec2& position, const glm::vec2& direction, float speed, float health){
+	m_positionsX.push_back(position.x);
+	m_positionsY.push_back(position.y);
+	m_directionsX.push_back(direction.x);
+	m_directionsY.push_back(direction.y);
+	m_speeds.push_back(speed);
+	m_health.push_back(health);
+	m_kinds.push_back(kind);
+	m_frames.push_back(0);
+	m_hitWall.push_back(0);
+	//Xorshift never leaves zero
+	m_randomStates.push_back(m_randomEngine() | 1);
+
+	return m_kinds.size() - 1;
+}
+
+void AgentStore::move(AgentKind kind, float deltaTime, int begin, int end){
+	float* positionsX = m_positionsX.data();
+	float* positionsY = m_positionsY.data();
+	const float* directionsX = m_directionsX.data();
+	const float* directionsY = m_directionsY.data();
+	const float* speeds = m_speeds.data();
+	const AgentKind* kinds = m_kinds.data();
+
+	for (int i = begin; i < end; i++)
+	{
+		float step = speeds[i] * deltaTime;
+		bool moves = kinds[i] == kind;
+		positionsX[i] = moves ? positionsX[i] + directionsX[i] * step : positionsX[i];
+		positionsY[i] = moves ? positionsY[i] + directionsY[i] * step : positionsY[i];
+	}
+}
+
+void AgentStore::collideWithLevel(AgentKind kind, const std::vector<std::string>& levelData, int begin, int end){
+	for (int i = begin; i < end; i++)
+	{
+		if (m_kinds[i] != kind)
+		{
+			continue;
+		}
+
+		glm::vec2 position = getPosition(i);
+		m_hitWall[i] = Agent::collideWithLevel(levelData, position);
+		m_positionsX[i] = position.x;
+		m_positionsY[i] = position.y;
+	}
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+#include <random>
+
+#include <GameEngine\SpriteBatch.h>
+#include <GameEngine\Camera2D.h>
+#include <GameEngine\SpatialGrid.h>
+
+enum class AgentKind : unsigned char{
+	HUMAN,
+	ZOMBIE
+};
+
+/// All humans and zombies of the level, stored column by column (structure of arrays).
+/// An agent is just an index into the columns, there are no objects and no virtual calls.
+/// Infecting a human flips its kind in place, killing an agent moves the last one into its index.
+/// The update kernels work on index ranges and only write the columns of their own agents, so
+/// several threads can update different ranges at once. The player stays an Agent object of its own
+class AgentStore
+{
+public:
+	AgentStore();
+	~AgentStore();
+
+	/// Loads the textures, call it once before drawing
+	void init();
+
+	/// Removes all agents, the columns keep their memory
+	void clear();
+
+	/// Seeds the random numbers of the agents added from now on
+	void seed(unsigned int seed);
+
+	/// Adds a human walking into a random direction and returns its index
+	int addHuman(const glm::vec2& position, float speed, float health);
+	/// Adds a zombie and returns its index
+	int addZombie(const glm::vec2& position, float speed, float health);
+
+	/// Turns the human into a zombie without moving it to another index
+	void infect(int index, float speed, float health);
+
+	/// Moves the last agent into index
+	void remove(int index);
+
+	/// Returns true if health is zero or less --> agent died
+	bool applyDamage(int index, float damage);
+
+	/// Random walk of the humans in [begin, end), they turn every few frames and when they hit a wall
+	void updateHumans(const std::vector<std::string>& levelData, float deltaTime, int begin, int end);
+
+	/// Every zombie in [begin, end) walks towards the center of the nearest box in targetGrid
+	void updateZombies(const std::vector<std::string>& levelData, const GameEngine::SpatialGrid& targetGrid, float deltaTime, int begin, int end);
+
+	/// Moves the agent by offset, used to push agents apart
+	void moveBy(int index, const glm::vec2& offset);
+
+	void draw(GameEngine::SpriteBatch& spriteBatch, GameEngine::Camera2D& camera);
+
+	int size() const { return m_kinds.size(); }
+	int getNumHumans() const { return m_numHumans; }
+	int getNumZombies() const { return m_kinds.size() - m_numHumans; }
+
+	AgentKind getKind(int index) const { return m_kinds[index]; }
+	glm::vec2 getPosition(int index) const { return glm::vec2(m_positionsX[index], m_positionsY[index]); }
+	float getHealth(int index) const { return m_health[index]; }
+
+private:
+	int add(AgentKind kind, const glm::vec2& position, const glm::vec2& direction, float speed, float health);
+
+	/// position += direction * speed * deltaTime for the agents of one kind in [begin, end).
+	/// Branch free over the float columns, so the compiler can vectorize it
+	void move(AgentKind kind, float deltaTime, int begin, int end);
+
+	/// Level collision for the agents of one kind in [begin, end), m_hitWall tells which of them hit a wall
+	void collideWithLevel(AgentKind kind, const std::vector<std::string>& levelData, int begin, int end);
+
+	//The columns, all of the same length
+	std::vector<float> m_positionsX; ///< Bottom left corner
+	std::vector<float> m_positionsY;
+	std::vector<float> m_directionsX;
+	std::vector<float> m_directionsY;
+	std::vector<float> m_speeds;
+	std::vector<float> m_health;
+	std::vector<AgentKind> m_kinds;
+	std::vector<int> m_frames; ///< Frames since a human last changed its direction
+	std::vector<unsigned char> m_hitWall; ///< Set by collideWithLevel for the current update
+	std::vector<unsigned int> m_randomStates; ///< Every agent draws its own random numbers, independent of the update order
+
+	int m_numHumans = 0;
+
+	std::mt19937 m_randomEngine; ///< Start directions and the seeds of m_randomStates
+
+	GLuint m_humanTextureID = 0;
+	GLuint m_zombieTextureID = 0;
+};
@@ -3,8 +3,9 @@
 #include <GameEngine/ResourceManager.h>
 #include "Level.h"
 #include "Agent.h"
-#include "Human.h"
-#include "Zombie.h"
+
+#include <algorithm>
+#include <limits>
 
 
 Bullet::Bullet(glm::vec2 pos, glm::vec2 dir, float damage, float speed) :
@@ -36,7 +37,7 @@ void Bullet::draw(GameEngine::SpriteBatch& spriteBatch){
 	glm::vec4 destRect = glm::vec4(m_position.x - BULLET_RADIUS, m_position.y - BULLET_RADIUS, BULLET_RADIUS * 2, BULLET_RADIUS * 2);
 
 	glm::vec4 uvRect(0.0f, 0.0f, 1.0f, 1.0f);
-	static GameEngine::GLTexture texture = GameEngine::ResourceManager::getTexture("Textures/circle.png");
+	static GameEngine::GLTexture texture = GameEngine::ResourceManager::getTextureAsync("Textures/circle.png");
 
 	GameEngine::ColorRGBA8 color;
 	color.r = 75;
@@ -49,43 +50,133 @@ void Bullet::draw(GameEngine::SpriteBatch& spriteBatch){
 }
 
 
-bool Bullet::update(const std::vector<std::string>& levelData, float deltaTime){
-	m_position += m_direction * m_speed * deltaTime;
+bool Bullet::update(const std::vector<std::string>& levelData, const GameEngine::SpatialGrid& agentGrid, float deltaTime,
+	std::vector<int>& candidates, int& hitAgent){
+	glm::vec2 end = m_position + m_direction * m_speed * deltaTime;
 	//m_lifeTime--;
-	return collideWithWorld(levelData);
-}
 
-bool Bullet::collideWithAgent(Agent* agent){
-	const float MIN_DISTANCE = AGENT_RADIUS + float(BULLET_RADIUS);
+	//Nothing behind the first wall counts
+	float hitFraction = 1.0f;
+	bool hit = sweepWorld(levelData, end, hitFraction);
+	hitAgent = -1;
+
+	//Only the agents around the way the bullet flies this step
+	glm::vec2 minCorner = glm::min(m_position, end) - glm::vec2((float)BULLET_RADIUS);
+	glm::vec2 maxCorner = glm::max(m_position, end) + glm::vec2((float)BULLET_RADIUS);
+	agentGrid.query(glm::vec4(minCorner, maxCorner - minCorner), candidates);
+
+	for (int id : candidates)
+	{
+		const glm::vec4& box = agentGrid.getBox(id);
+		float agentFraction;
+		//Ids are sorted, so on a tie the smaller id wins. A wall right at the same spot wins as well
+		if (sweepAgent(glm::vec2(box.x, box.y), end, agentFraction) && (agentFraction < hitFraction || (!hit && agentFraction == hitFraction)))
+		{
+			hitFraction = agentFraction;
+			hitAgent = id;
+			hit = true;
+		}
+	}
 
-	glm::vec2 centerPosA = m_position;
-	glm::vec2 centerPosB = agent->getPosition() + glm::vec2(AGENT_RADIUS);
+	m_position += (end - m_position) * hitFraction;
 
-	glm::vec2 distVec = centerPosA - centerPosB;
+	return hit;
+}
 
-	float distance = glm::length(distVec);
+bool Bullet::sweepWorld(const std::vector<std::string>& levelData, const glm::vec2& end, float& hitFraction) const {
+	auto isBlocked = [&](const glm::ivec2& tile){
+		//Outside the world counts as a wall
+		return tile.x < 0 || tile.x >= levelData[0].size() || tile.y < 0 || tile.y >= levelData.size() ||
+			levelData[tile.y][tile.x] != '.';
+	};
 
-	float collisionDepth = MIN_DISTANCE - distance;
+	glm::ivec2 tile(floor(m_position.x / TILE_WIDTH), floor(m_position.y / TILE_WIDTH));
+	glm::ivec2 endTile(floor(end.x / TILE_WIDTH), floor(end.y / TILE_WIDTH));
 
-	if (collisionDepth >= 0){
-		//Bullet collided with the agent
+	if (isBlocked(tile))
+	{
+		hitFraction = 0.0f;
 		return true;
 	}
-	else{
-		return false;
+
+	glm::vec2 way = end - m_position;
+	glm::ivec2 step(way.x > 0.0f ? 1 : -1, way.y > 0.0f ? 1 : -1);
+
+	//Fraction of the way at which the next tile border is crossed, and how far apart the borders are
+	glm::vec2 nextBorder(std::numeric_limits<float>::max());
+	glm::vec2 borderDistance(std::numeric_limits<float>::max());
+	if (way.x != 0.0f)
+	{
+		nextBorder.x = ((tile.x + (step.x > 0 ? 1 : 0)) * TILE_WIDTH - m_position.x) / way.x;
+		borderDistance.x = TILE_WIDTH / abs(way.x);
+	}
+	if (way.y != 0.0f)
+	{
+		nextBorder.y = ((tile.y + (step.y > 0 ? 1 : 0)) * TILE_WIDTH - m_position.y) / way.y;
+		borderDistance.y = TILE_WIDTH / abs(way.y);
+	}
+
+	while (tile != endTile)
+	{
+		float fraction;
+		if (nextBorder.x < nextBorder.y)
+		{
+			fraction = nextBorder.x;
+			nextBorder.x += borderDistance.x;
+			tile.x += step.x;
+		}
+		else
+		{
+			fraction = nextBorder.y;
+			nextBorder.y += borderDistance.y;
+			tile.y += step.y;
+		}
+
+		//Rounding can step past the end tile, the way ends there anyway
+		if (fraction > 1.0f)
+		{
+			break;
+		}
+
+		if (isBlocked(tile))
+		{
+			hitFraction = std::max(fraction, 0.0f);
+			return true;
+		}
 	}
+
+	return false;
 }
 
-bool Bullet::collideWithWorld(const std::vector<std::string>& levelData){
-	glm::ivec2 gridPosition;
-	gridPosition.x = floor(m_position.x / (float)TILE_WIDTH);
-	gridPosition.y = floor(m_position.y / (float)TILE_WIDTH);
+bool Bullet::sweepAgent(const glm::vec2& agentPosition, const glm::vec2& end, float& hitFraction) const {
+	const float MIN_DISTANCE = AGENT_RADIUS + float(BULLET_RADIUS);
+
+	glm::vec2 way = end - m_position;
+	glm::vec2 centerToStart = m_position - (agentPosition + glm::vec2(AGENT_RADIUS));
 
-	//If we are outside the world, just return
-	if (gridPosition.x < 0 || gridPosition.x >= levelData[0].size()
-		|| gridPosition.y < 0 || gridPosition.y >= levelData.size()){
+	//Already touching at the start
+	float c = glm::dot(centerToStart, centerToStart) - MIN_DISTANCE * MIN_DISTANCE;
+	if (c <= 0.0f)
+	{
+		hitFraction = 0.0f;
 		return true;
 	}
 
-	return (levelData[gridPosition.y][gridPosition.x] != '.');
-}
\ No newline at end of file
+	//Solve |centerToStart + way * t| = MIN_DISTANCE for the first t in [0, 1]
+	float a = glm::dot(way, way);
+	float b = 2.0f * glm::dot(centerToStart, way);
+	float discriminant = b * b - 4.0f * a * c;
+	if (a == 0.0f || discriminant < 0.0f)
+	{
+		return false;
+	}
+
+	float t = (-b - sqrt(discriminant)) / (2.0f * a);
+	if (t < 0.0f || t > 1.0f)
+	{
+		return false;
+	}
+
+	hitFraction = t;
+	return true;
+}
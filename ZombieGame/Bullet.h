@@ -1,11 +1,10 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <vector>
+#include <string>
 #include "GameEngine/SpriteBatch.h"
-
-class Human;
-class Zombie;
-class Agent;
+#include "GameEngine/SpatialGrid.h"
 
 const int BULLET_RADIUS = 5;
 
@@ -17,17 +16,21 @@ public:
 	~Bullet();
 
 	void draw(GameEngine::SpriteBatch& spriteBatch);
-	//Returns true when we are out of life or hit something --> delete bullet
-	bool update(const std::vector<std::string>& levelData, float deltaTime);
-
-	bool collideWithAgent(Agent* agent);
+	//Moves the bullet along its way for this step and returns true when it hit a wall or an agent --> delete bullet.
+	//hitAgent is the id of the agent in agentGrid or -1, the bullet stops where it hit.
+	//candidates is just memory for the grid query
+	bool update(const std::vector<std::string>& levelData, const GameEngine::SpatialGrid& agentGrid, float deltaTime,
+		std::vector<int>& candidates, int& hitAgent);
 
 	float getDamage() const { return m_damage; }
 
 	glm::vec2 getPosition() const { return m_position; }
 
 private:
-	bool collideWithWorld(const std::vector<std::string>& levelData);
+	//Walks the tiles between m_position and end (DDA), hitFraction is how far along the way the first wall starts
+	bool sweepWorld(const std::vector<std::string>& levelData, const glm::vec2& end, float& hitFraction) const;
+	//hitFraction is how far along the way the bullet first touches the agent, agentPosition is its bottom left corner
+	bool sweepAgent(const glm::vec2& agentPosition, const glm::vec2& end, float& hitFraction) const;
 
 	float m_damage; 
 	glm::vec2 m_direction;
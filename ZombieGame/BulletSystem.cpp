@@ -0,0 +1,59 @@
+#include "BulletSystem.h"
+
+
+BulletSystem::BulletSystem()
+{
+}
+
+
+BulletSystem::~BulletSystem()
+{
+}
+
+void BulletSystem::init(int capacity){
+	m_bullets.reserve(capacity);
+	m_hits.reserve(capacity);
+}
+
+void BulletSystem::clear(){
+	m_bullets.clear();
+	m_hits.clear();
+}
+
+void BulletSystem::add(const glm::vec2& position, const glm::vec2& direction, float damage, float speed){
+	m_bullets.emplace_back(position, direction, damage, speed);
+}
+
+const std::vector<BulletHit>& BulletSystem::update(const std::vector<std::string>& levelData, const GameEngine::SpatialGrid& agentGrid, float deltaTime){
+	m_hits.clear();
+
+	for (size_t i = 0; i < m_bullets.size();)
+	{
+		int hitAgent;
+		//if update returns true, the bullet hit a wall or an agent
+		if (m_bullets[i].update(levelData, agentGrid, deltaTime, m_candidates, hitAgent))
+		{
+			if (hitAgent != -1)
+			{
+				m_hits.push_back(BulletHit{ hitAgent, m_bullets[i].getDamage(), m_bullets[i].getPosition() });
+			}
+
+			//The last bullet takes its place and is updated next
+			m_bullets[i] = m_bullets.back();
+			m_bullets.pop_back();
+		}
+		else
+		{
+			i++;
+		}
+	}
+
+	return m_hits;
+}
+
+void BulletSystem::draw(GameEngine::SpriteBatch& spriteBatch){
+	for (auto& bullet : m_bullets)
+	{
+		bullet.draw(spriteBatch);
+	}
+}
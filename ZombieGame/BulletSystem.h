@@ -0,0 +1,48 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+#include <string>
+
+#include <GameEngine\SpriteBatch.h>
+#include <GameEngine\SpatialGrid.h>
+
+#include "Bullet.h"
+
+/// A bullet that hit an agent during the last update
+struct BulletHit{
+	int agent; ///< Id in the agent grid the bullets were updated with
+	float damage;
+	glm::vec2 position;
+};
+
+/// All flying bullets in one pool. The bullets live in one vector that only grows,
+/// a bullet that hits something is replaced by the last one, so firing doesn't allocate once it is warmed up.
+/// Every bullet sweeps its way of the step against the tiles and the agents near that way,
+/// so fast bullets don't fly through anything and a burst costs about the same per pellet as a single shot
+class BulletSystem
+{
+public:
+	BulletSystem();
+	~BulletSystem();
+
+	/// Reserves room for capacity bullets
+	void init(int capacity);
+
+	void clear();
+
+	void add(const glm::vec2& position, const glm::vec2& direction, float damage, float speed);
+
+	/// Moves all bullets and removes the ones that hit a wall or an agent.
+	/// Returns the agent hits in the order of the bullets, the vector is reused by the next update
+	const std::vector<BulletHit>& update(const std::vector<std::string>& levelData, const GameEngine::SpatialGrid& agentGrid, float deltaTime);
+
+	void draw(GameEngine::SpriteBatch& spriteBatch);
+
+	int size() const { return m_bullets.size(); }
+
+private:
+	std::vector<Bullet> m_bullets;
+	std::vector<BulletHit> m_hits;
+	std::vector<int> m_candidates; ///< Result of the grid queries, keeps its capacity
+};
@@ -25,7 +25,7 @@ Gun::~Gun()
 	//Empty
 }
 
-void Gun::update(bool isMouseDown, const glm::vec2& position, const glm::vec2& direction, std::vector<Bullet>& bullets, float deltaTime){
+void Gun::update(bool isMouseDown, const glm::vec2& position, const glm::vec2& direction, BulletSystem& bullets, float deltaTime){
 	m_frameCounter+= 1.0f * deltaTime;
 	if (m_frameCounter >= m_fireRate && isMouseDown)
 	{
@@ -34,7 +34,7 @@ void Gun::update(bool isMouseDown, const glm::vec2& position, const glm::vec2& d
 	}
 }
 
-void Gun::fire(const glm::vec2& position, const glm::vec2& direction, std::vector<Bullet>& bullets){
+void Gun::fire(const glm::vec2& position, const glm::vec2& direction, BulletSystem& bullets){
 	std::mt19937 randomEngine(time(nullptr));
 	std::uniform_real_distribution<float> randRotate(-m_spread * DEG_TO_RAD, m_spread * DEG_TO_RAD);
 
@@ -42,7 +42,7 @@ void Gun::fire(const glm::vec2& position, const glm::vec2& direction, std::vecto
 
 	for (int i = 0; i < m_bulletsPerShot; i++)
 	{
-		bullets.emplace_back(position,
+		bullets.add(position,
 							glm::rotate(direction, randRotate(randomEngine)),
 							m_bulletDamage,
 							m_bulletSpeed);
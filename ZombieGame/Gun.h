@@ -3,7 +3,7 @@
 #include <string>
 #include <glm\glm.hpp>
 #include <vector>
-#include "Bullet.h"
+#include "BulletSystem.h"
 
 #include <GameEngine\AudioEngine.h>
 
@@ -13,7 +13,7 @@ public:
 	Gun(std::string name, int fireRate, int bulletsPerShot, float spread, float bulletSpeed, float bulletDamage, GameEngine::SoundEffect fireEffect);
 	~Gun();
 
-	void update(bool isMouseDown, const glm::vec2& position, const glm::vec2& direction, std::vector<Bullet>& bullets, float deltaTime);
+	void update(bool isMouseDown, const glm::vec2& position, const glm::vec2& direction, BulletSystem& bullets, float deltaTime);
 
 private:
 
@@ -33,7 +33,7 @@ private:
 
 	float m_frameCounter;
 
-	void fire(const glm::vec2& position, const glm::vec2& direction, std::vector<Bullet>& bullets);
+	void fire(const glm::vec2& position, const glm::vec2& direction, BulletSystem& bullets);
 
 };
 
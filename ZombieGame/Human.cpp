@@ -51,8 +51,7 @@ void Human::init(float speed, glm::vec2 position){
 }
 
 
-void Human::update(const std::vector<std::string>& levelData,
-	std::vector<Human*>& humans, std::vector<Zombie*>& zombies, float deltaTime){
+void Human::update(const std::vector<std::string>& levelData, float deltaTime){
 
 	static std::mt19937 randomEngine(time(nullptr));
 	static std::uniform_real_distribution<float> randRotate(-40.0f * DEG_TO_RAD, 40.0f * DEG_TO_RAD);
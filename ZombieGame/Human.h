@@ -13,8 +13,7 @@ public:
 	void init(float speed, glm::vec2 position);
 
 
-	virtual void update(const std::vector<std::string>& levelData,
-		std::vector<Human*>& humans, std::vector<Zombie*>& zombies, float deltaTime) override;
+	virtual void update(const std::vector<std::string>& levelData, float deltaTime) override;
 	
 	glm::vec2 getDirection(){
 		return m_direction;
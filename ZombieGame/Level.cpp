@@ -1,7 +1,8 @@
 #include "Level.h"
 
 #include <GameEngine\GameEngineErrors.h>
-#include <fstream>
+#include <GameEngine\IOManager.h>
+#include <sstream>
 #include <iostream>
 
 #include <GameEngine\ResourceManager.h>
@@ -12,23 +13,22 @@ Level::Level(const std::string fileName)
 {
 	
 
-	std::fstream file;
-	file.open(fileName);
+	GameEngine::FileView file;
 
 	//Error checking
-	if (file.fail())
+	if (!file.open(fileName))
 	{
 		GameEngine::fatalError("Failed to open " + fileName);
 	}
 
 	//Throw away the first sting in tap
+	size_t position = 0;
 	std::string tmp;
-	file >> tmp >> m_numHumans;
-
-	std::getline(file, tmp); //Throw away the rest of the first line
+	file.getLine(position, tmp);
+	std::istringstream(tmp) >> tmp >> m_numHumans;
 
 	//Read the level data
-	while (std::getline(file, tmp)){
+	while (file.getLine(position, tmp)){
 		m_levelData.push_back(tmp);
 	}
 
@@ -104,6 +104,7 @@ Level::Level(const std::string fileName)
 
 Level::~Level()
 {
+	m_spriteBatch.dispose();
 }
 
 
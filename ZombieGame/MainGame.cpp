@@ -4,6 +4,7 @@
 #include <GameEngine\Timing.h>
 #include <GameEngine\GameEngineErrors.h>
 #include <GameEngine\ResourceManager.h>
+#include <GameEngine\Profiler.h>
 
 #include <SDL/SDL.h>
 #include <iostream>
@@ -14,8 +15,6 @@
 
 #include <algorithm>
 
-#include "Zombie.h"
-
 #include "Gun.h"
 
 
@@ -27,6 +26,19 @@ const float PLAYER_SPEED = 5.0f;
 const float HUMAN_SPEED = 1.0f;
 const float ZOMBIE_SPEED = 1.3f;
 
+const float HUMAN_HEALTH = 20.0f;
+const float ZOMBIE_HEALTH = 150.0f;
+
+const int NUM_UPDATE_THREADS = 0; ///< 0 = one per core, 1 = single threaded. Both give the same results
+const unsigned int RANDOM_SEED = 0; ///< 0 = seed with the time, anything else replays the same outbreak
+
+const int BULLET_CAPACITY = 1024; ///< Bullets the pool has room for before it has to grow
+const float TEXTURE_UPLOAD_MILLISECONDS = 2.0f; ///< Per frame, for the textures loaded in the background
+
+const int MIN_AGENTS_PER_JOB = 256;
+const int MIN_ROWS_PER_JOB = 4;
+const int MIN_PAIRS_PER_JOB = 256;
+
 
 MainGame::MainGame() :
 m_gameState(GameState::PLAY),
@@ -38,19 +50,15 @@ m_numZombiesKilled(0){
 }
 
 MainGame::~MainGame() {
-	//Delete levels, humans and zombies
+	//Delete levels and the player
 	for (int i = 0; i < m_levels.size(); i++)
 	{
 		delete m_levels[i];
 	}
-	for (int i = 0; i < m_humans.size(); i++)
-	{
-		delete m_humans[i];
-	}
-	for (int i = 0; i < m_zombies.size(); i++)
-	{
-		delete m_zombies[i];
-	}
+	delete m_player;
+
+	m_agentSpriteBatch.dispose();
+	m_hudSpriteBatch.dispose();
 }
 
 void MainGame::run() {
@@ -101,6 +109,8 @@ void MainGame::initSystems() {
 	}); // using a Lambda to create a function to give as a function pointer
 
 	m_particleEngine.addParticleBatch(m_bloodParticleBatch);
+
+	m_jobSystem.init(NUM_UPDATE_THREADS);
 }
 
 
@@ -110,29 +120,39 @@ void MainGame::initLevel(){
 	m_currentLevel = 0;
 
 	m_player = new Player();
+	m_bullets.init(BULLET_CAPACITY);
+	//Loads in the background, so the first shot doesn't wait for it
+	GameEngine::ResourceManager::getTextureAsync("Textures/circle.png");
+
 	m_player->init(PLAYER_SPEED, m_levels[m_currentLevel]->getStartPlayerPos(), &m_inputManager, &m_camera, &m_bullets);
 
-	m_humans.push_back(m_player);
+	unsigned int seed = RANDOM_SEED != 0 ? RANDOM_SEED : (unsigned int)time(nullptr);
+
+	m_agents.init();
+	m_agents.clear();
+	m_agents.seed(seed);
 
 	std::mt19937 randomEngine;
-	randomEngine.seed(time(nullptr));
+	randomEngine.seed(seed);
 	std::uniform_int_distribution<int> randX(2, m_levels[m_currentLevel]->getWidth() - 2);
 	std::uniform_int_distribution<int> randY(2, m_levels[m_currentLevel]->getHeight() - 2);
 
 	//Add all the random humans
 	for (int i = 0; i < m_levels[m_currentLevel]->getNumHumans(); i++)
 	{
-		m_humans.push_back(new Human);
 		glm::vec2 pos(randX(randomEngine) * TILE_WIDTH, randY(randomEngine) * TILE_WIDTH);
-		m_humans.back()->init(HUMAN_SPEED, pos);
+		m_agents.addHuman(pos, HUMAN_SPEED, HUMAN_HEALTH);
 	}
 
+	Level* level = m_levels[m_currentLevel];
+	m_agentGrid.init(glm::vec2(0.0f), glm::vec2(level->getWidth() * TILE_WIDTH, level->getHeight() * TILE_WIDTH), TILE_WIDTH);
+	m_humanGrid.init(glm::vec2(0.0f), glm::vec2(level->getWidth() * TILE_WIDTH, level->getHeight() * TILE_WIDTH), TILE_WIDTH);
+
 	//Add all the zombies
 	const std::vector<glm::vec2> zombiePositions = m_levels[m_currentLevel]->getStartZombiePositions();
 	for (int i = 0; i < zombiePositions.size(); i++)
 	{
-		m_zombies.push_back(new Zombie);
-		m_zombies.back()->init(ZOMBIE_SPEED, zombiePositions[i]);
+		m_agents.addZombie(zombiePositions[i], ZOMBIE_SPEED, ZOMBIE_HEALTH);
 	}
 
 	//Set up the guns of the player (pistol, shot gun, machine gun)
@@ -168,6 +188,8 @@ void MainGame::gameLoop() {
 	const float CAMERA_SCALE = 1.0f / 3.0f;
 	m_camera.setScale(CAMERA_SCALE);
 
+	GameEngine::Profiler::setThreadName("Main");
+
 	float previousTicks = SDL_GetTicks();
 
 	while (m_gameState == GameState::PLAY)
@@ -185,6 +207,12 @@ void MainGame::gameLoop() {
 
 		processInput();
 
+		//F9 starts a profiler capture, the next F9 writes it out
+		if (m_inputManager.isKeyPressed(SDLK_F9))
+		{
+			GameEngine::Profiler::toggleCapture("profile.json");
+		}
+
 		int i = 0;
 		while (totalDeltaTime > 0.0f && i < MAX_PHYSICS_STEPS)
 		{
@@ -205,158 +233,199 @@ void MainGame::gameLoop() {
 
 		m_hudCamera.update();
 
+		GameEngine::ResourceManager::updateTextures(TEXTURE_UPLOAD_MILLISECONDS);
+
 		drawGame();
 
 		m_fps = fpsLimiter.end();
 		std::cout << m_fps << std::endl;
+
+		GameEngine::Profiler::endFrame();
 	}
 }
 
 void MainGame::updateAgents(float deltaTime){
-	//Update all humans
-	for (int i = 0; i < m_humans.size(); i++)
+	PROFILE_ZONE("MainGame::updateAgents");
+
+	const std::vector<std::string>& levelData = m_levels[m_currentLevel]->getLevelData();
+
+	//Update the player, then all humans. Every agent only moves itself, so ranges of agents run in parallel
+	m_player->update(levelData, deltaTime);
+
+	m_jobSystem.parallelFor(m_agents.size(), MIN_AGENTS_PER_JOB, [&](int begin, int end, int range){
+		m_agents.updateHumans(levelData, deltaTime, begin, end);
+	});
+
+	//Index the player and the humans where they are now, every zombie looks for its prey in there
+	m_humanGrid.clear();
+	m_humanGrid.add(glm::vec4(m_player->getPosition(), AGENT_WIDTH, AGENT_WIDTH));
+	for (int i = 0; i < m_agents.size(); i++)
 	{
-		m_humans[i]->update(m_levels[m_currentLevel]->getLevelData(), m_humans, m_zombies, deltaTime);
+		if (m_agents.getKind(i) == AgentKind::HUMAN)
+		{
+			m_humanGrid.add(glm::vec4(m_agents.getPosition(i), AGENT_WIDTH, AGENT_WIDTH));
+		}
 	}
+	m_humanGrid.build();
 
 	//Update all zombies
-	for (int i = 0; i < m_zombies.size(); i++)
+	m_jobSystem.parallelFor(m_agents.size(), MIN_AGENTS_PER_JOB, [&](int begin, int end, int range){
+		m_agents.updateZombies(levelData, m_humanGrid, deltaTime, begin, end);
+	});
+
+	collideAgents();
+}
+
+void MainGame::collideAgents(){
+	PROFILE_ZONE("MainGame::collideAgents");
+
+	//Agents keep their index as id in the grid, the player comes last
+	m_agentGrid.clear();
+	for (int i = 0; i < m_agents.size(); i++)
 	{
-		m_zombies[i]->update(m_levels[m_currentLevel]->getLevelData(), m_humans, m_zombies, deltaTime);
+		m_agentGrid.add(glm::vec4(m_agents.getPosition(i), AGENT_WIDTH, AGENT_WIDTH));
 	}
+	const int playerID = m_agentGrid.add(glm::vec4(m_player->getPosition(), AGENT_WIDTH, AGENT_WIDTH));
+	m_agentGrid.build();
+
+	//Find the overlapping pairs in ranges of grid rows, sorting them makes the order independent of the ranges
+	const int numRows = m_agentGrid.getNumYCells();
+	m_pairBuffers.resize(m_jobSystem.getNumRanges(numRows, MIN_ROWS_PER_JOB));
+	m_jobSystem.parallelFor(numRows, MIN_ROWS_PER_JOB, [&](int begin, int end, int range){
+		m_pairBuffers[range].clear();
+		m_agentGrid.findPairs(begin, end, m_pairBuffers[range]);
+	});
+
+	m_pairs.clear();
+	for (auto& pairs : m_pairBuffers)
+	{
+		m_pairs.insert(m_pairs.end(), pairs.begin(), pairs.end());
+	}
+	std::sort(m_pairs.begin(), m_pairs.end());
 
-	//Update zombie collisions
-	for (int i = 0; i < m_zombies.size(); i++)
+	//Every contact is worked out from the positions before any push
+	m_contactBuffers.resize(m_jobSystem.getNumRanges(m_pairs.size(), MIN_PAIRS_PER_JOB));
+	for (auto& contacts : m_contactBuffers)
 	{
-		//Collide with other zombies
-		for (int j = i + 1; j < m_zombies.size(); j++) {
-			m_zombies[i]->collideWithAgent(m_zombies[j]);
-		}
+		contacts.clear();
+	}
+	m_jobSystem.parallelFor(m_pairs.size(), MIN_PAIRS_PER_JOB, [&](int begin, int end, int range){
+		for (int k = begin; k < end; k++)
+		{
+			const glm::vec4& boxA = m_agentGrid.getBox(m_pairs[k].first);
+			const glm::vec4& boxB = m_agentGrid.getBox(m_pairs[k].second);
+			glm::vec2 positionA(boxA.x, boxA.y);
+			glm::vec2 positionB(boxB.x, boxB.y);
 
-		//Collide with humans (player is zero so skip him)
-		for (int j = 1; j < m_humans.size(); j++) {
-			if (m_zombies[i]->collideWithAgent(m_humans[j])){
-				//Add the new zombie
-				m_zombies.push_back(new Zombie);
-				m_zombies.back()->init(ZOMBIE_SPEED, m_humans[j]->getPosition());
-				//Delete the human
-				delete m_humans[j];
-				m_humans[j] = m_humans.back();
-				m_humans.pop_back();
+			if (Agent::collideAgents(positionA, positionB))
+			{
+				m_contactBuffers[range].push_back(AgentContact{ m_pairs[k].first, m_pairs[k].second,
+					positionA - glm::vec2(boxA.x, boxA.y), positionB - glm::vec2(boxB.x, boxB.y) });
 			}
 		}
+	});
+
+	m_infectedHumans.assign(m_agents.size(), false);
+
+	//Apply the contacts range by range, that is in pair order no matter how many threads found them
+	for (auto& contacts : m_contactBuffers)
+	{
+		for (auto& contact : contacts)
+		{
+			int i = contact.first;
+			int j = contact.second;
 
-		//Collide with player
-		if (m_zombies[i]->collideWithAgent(m_humans[0])){
-			std::printf("Killed by zombie %d with health: %d at Pos: %d, %d \n", i, m_zombies[i]->getHealth(), m_zombies[i]->getPosition().x, m_zombies[i]->getPosition().y);
-			GameEngine::fatalError("YOU LOSE");
+			if (j == playerID)
+			{
+				if (m_agents.getKind(i) == AgentKind::ZOMBIE)
+				{
+					//Collide with player
+					std::printf("Killed by zombie %d with health: %f at Pos: %f, %f \n", i, m_agents.getHealth(i), m_agents.getPosition(i).x, m_agents.getPosition(i).y);
+					GameEngine::fatalError("YOU LOSE");
+				}
+				else if (!m_infectedHumans[i])
+				{
+					m_agents.moveBy(i, contact.firstOffset);
+					m_player->setPosition(m_player->getPosition() + contact.secondOffset);
+				}
+			}
+			else if (m_agents.getKind(i) == AgentKind::ZOMBIE && m_agents.getKind(j) == AgentKind::ZOMBIE)
+			{
+				//Collide with other zombies
+				m_agents.moveBy(i, contact.firstOffset);
+				m_agents.moveBy(j, contact.secondOffset);
+			}
+			else if (m_agents.getKind(i) == AgentKind::HUMAN && m_agents.getKind(j) == AgentKind::HUMAN)
+			{
+				//Collide with other humans
+				if (!m_infectedHumans[i] && !m_infectedHumans[j])
+				{
+					m_agents.moveBy(i, contact.firstOffset);
+					m_agents.moveBy(j, contact.secondOffset);
+				}
+			}
+			else
+			{
+				//Collide zombie with human, a bitten human is turned after all contacts are done
+				int human = m_agents.getKind(i) == AgentKind::HUMAN ? i : j;
+				if (!m_infectedHumans[human])
+				{
+					m_infectedHumans[human] = true;
+					m_agents.moveBy(i, contact.firstOffset);
+					m_agents.moveBy(j, contact.secondOffset);
+				}
+			}
 		}
 	}
 
-	//Update human collisions
-	for (int i = 0; i < m_humans.size(); i++)
+	//Infected humans become zombies right where they are
+	for (int i = 0; i < m_agents.size(); i++)
 	{
-		//Collide with other humans
-		for (int j = i + 1; j < m_humans.size(); j++) {
-			m_humans[i]->collideWithAgent(m_humans[j]);
+		if (m_infectedHumans[i])
+		{
+			m_agents.infect(i, ZOMBIE_SPEED, ZOMBIE_HEALTH);
 		}
 	}
 }
 
 void MainGame::updateBullets(float deltaTime){
-	//Update and collide with world
-	for (int i = 0; i < m_bullets.size();)
+	PROFILE_ZONE("MainGame::updateBullets");
+
+	//The agents where they are now, the bullets look for their targets in there. The player can't be hit
+	m_agentGrid.clear();
+	for (int i = 0; i < m_agents.size(); i++)
 	{
-		//if update returns true, the bullet collided with a wall
-		if (m_bullets[i].update(m_levels[m_currentLevel]->getLevelData(), deltaTime)){
-			m_bullets[i] = m_bullets.back();
-			m_bullets.pop_back();
-		}
-		else{
-			i++;
-		}
+		m_agentGrid.add(glm::vec4(m_agents.getPosition(i), AGENT_WIDTH, AGENT_WIDTH));
 	}
+	m_agentGrid.build();
 
-	bool wasBulletRemoved;
-
-	//Collide with agents (humans and zombies)
-	for (int i = 0; i < m_bullets.size(); i++)
+	for (auto& hit : m_bullets.update(m_levels[m_currentLevel]->getLevelData(), m_agentGrid, deltaTime))
 	{
-		wasBulletRemoved = false;
-		//Loop through zombies
-		for (int j = 0; j < m_zombies.size();)
-		{
-			//Check collision
-			if (m_bullets[i].collideWithAgent(m_zombies[j])){
-				//Add blood first
-				addBlood(m_bullets[i].getPosition(), 5);
-
-				//Damage zombie and kill it if its out of health
-				if (m_zombies[j]->applyDamage(m_bullets[i].getDamage())){
-					//If the zombie died, remove it
-					delete m_zombies[j];
-					m_zombies[j] = m_zombies.back();
-					m_zombies.pop_back();
-					m_numZombiesKilled++;
-				}
-				else{
-					j++;
-				}
-
-				//Remove the bullet 
-				m_bullets[i] = m_bullets.back();
-				m_bullets.pop_back();
-
-				wasBulletRemoved = true;
-
-				i--; //Make sure we don't skip a bullet
+		//Add blood first
+		glm::vec2 position = hit.position;
+		addBlood(position, 5);
 
-				//Since the bullet died, no need to loop though the rest of the agents
-				break;
+		//Killed agents stay until all hits are done, so the ids don't change. Later hits only spill blood
+		if (m_agents.getHealth(hit.agent) > 0.0f && m_agents.applyDamage(hit.agent, hit.damage))
+		{
+			if (m_agents.getKind(hit.agent) == AgentKind::ZOMBIE)
+			{
+				m_numZombiesKilled++;
 			}
-			else{
-				j++;
+			else
+			{
+				m_numHumansKilled++;
 			}
 		}
+	}
 
-		//Loop through the humans
-		if (wasBulletRemoved == false)
+	//Remove the dead agents back to front, so the swapped in agent was already checked
+	for (int i = m_agents.size() - 1; i >= 0; i--)
+	{
+		if (m_agents.getHealth(i) <= 0.0f)
 		{
-			for (int j = 1; j < m_humans.size();)
-			{
-				if (m_bullets[i].collideWithAgent(m_humans[j])){
-					//Add blood first
-					addBlood(m_bullets[i].getPosition(), 5);
-
-					//Damage human and kill it if its out of health
-					if (m_humans[j]->applyDamage(m_bullets[i].getDamage())){
-						//If the human died, remove it
-						delete m_humans[j];
-						m_humans[j] = m_humans.back();
-						m_humans.pop_back();
-						m_numHumansKilled++;
-					}
-					else{
-						j++;
-					}
-
-					//Remove the bullet 
-					m_bullets[i] = m_bullets.back();
-					m_bullets.pop_back();
-
-					wasBulletRemoved = true;
-
-					i--; //Make sure we don't skip a bullet
-
-					//Since the bullet died, no need to loop though the rest of the agents
-					break;
-				}
-				else{
-					j++;
-				}
-			}
+			m_agents.remove(i);
 		}
-
 	}
 }
 
@@ -364,9 +433,9 @@ void MainGame::checkVictory(){
 	//TODO: Support for multiple levels!
 	// m_currentLevel++; initLevel(...);
 	//If all zombies are dead we win!
-	if (m_zombies.empty()){
+	if (m_agents.getNumZombies() == 0){
 
-		std::printf("*** YOU WIN! ***\n You killed %d humans and %d zombies. There are %d out of %d civilians remaining.", m_numHumansKilled, m_numZombiesKilled, m_humans.size() - 1, m_levels[m_currentLevel]->getNumHumans());
+		std::printf("*** YOU WIN! ***\n You killed %d humans and %d zombies. There are %d out of %d civilians remaining.", m_numHumansKilled, m_numZombiesKilled, m_agents.getNumHumans(), m_levels[m_currentLevel]->getNumHumans());
 
 		GameEngine::fatalError("");
 	}
@@ -426,31 +495,13 @@ void MainGame::drawGame() {
 	//Begin drawing agents
 	m_agentSpriteBatch.begin();
 
-	const glm::vec2 agentDims(AGENT_RADIUS * 2.0f);
+	//Draw the player, the humans and the zombies
+	m_player->draw(m_agentSpriteBatch);
 
-	//Draw the humans
-	for (int i = 0; i < m_humans.size(); i++)
-	{
-		if (m_camera.isBoxInView(m_humans[i]->getPosition(), agentDims))
-		{
-			m_humans[i]->draw(m_agentSpriteBatch);
-		}
-	}
-
-	//Draw the zombies
-	for (int i = 0; i < m_zombies.size(); i++)
-	{
-		if (m_camera.isBoxInView(m_zombies[i]->getPosition(), agentDims))
-		{
-			m_zombies[i]->draw(m_agentSpriteBatch);
-		}
-	}
+	m_agents.draw(m_agentSpriteBatch, m_camera);
 
 	//Draw the bullets
-	for (int i = 0; i < m_bullets.size(); i++)
-	{
-		m_bullets[i].draw(m_agentSpriteBatch);
-	}
+	m_bullets.draw(m_agentSpriteBatch);
 
 	m_agentSpriteBatch.end();
 
@@ -478,10 +529,10 @@ void MainGame::drawHUD(){
 
 	m_hudSpriteBatch.begin();
 
-	sprintf_s(buffer, "Num Humans %d", m_humans.size());
+	sprintf_s(buffer, "Num Humans %d", m_agents.getNumHumans() + 1);
 	m_spriteFont->draw(m_hudSpriteBatch, buffer, glm::vec2(0, 0), glm::vec2(0.5), 0.0f, GameEngine::ColorRGBA8(255, 255, 255, 255));
 
-	sprintf_s(buffer, "Num Zombies %d", m_zombies.size());
+	sprintf_s(buffer, "Num Zombies %d", m_agents.getNumZombies());
 	m_spriteFont->draw(m_hudSpriteBatch, buffer, glm::vec2(0, 36), glm::vec2(0.5), 0.0f, GameEngine::ColorRGBA8(255, 255, 255, 255));
 
 	m_hudSpriteBatch.end();
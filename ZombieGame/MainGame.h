@@ -8,17 +8,26 @@
 #include <GameEngine/AudioEngine.h>
 #include <GameEngine/ParticleEngine2D.h>
 #include <GameEngine/ParticleBatch2D.h>
+#include <GameEngine/SpatialGrid.h>
+#include <GameEngine/JobSystem.h>
 
 #include "Level.h"
 #include "Player.h"
-
-class Zombie;
+#include "AgentStore.h"
 
 enum class GameState{
 	PLAY,
 	EXIT
 };
 
+/// Two agents pushed apart, found in parallel and applied afterwards in pair order
+struct AgentContact{
+	int first;
+	int second; ///< Grid id, the player comes after the agents
+	glm::vec2 firstOffset;
+	glm::vec2 secondOffset;
+};
+
 class MainGame
 {
 public:
@@ -44,6 +53,9 @@ private:
 	///Updates all agents
 	void updateAgents(float deltaTime);
 
+	///Pushes overlapping agents apart and lets the zombies bite
+	void collideAgents();
+
 	///Update all bullets
 	void updateBullets(float deltaTime);
 
@@ -94,9 +106,17 @@ private:
 	int m_currentLevel; 
 
 	Player* m_player;
-	std::vector<Human*> m_humans; ///< Vector of all humans
-	std::vector<Zombie*> m_zombies; ///< Vector of all zombies
-	std::vector<Bullet> m_bullets; ///< Vector of bullets
+	AgentStore m_agents; ///< All humans and zombies except the player
+	BulletSystem m_bullets; ///< All flying bullets
+
+	GameEngine::SpatialGrid m_agentGrid; ///< Broadphase for agent collisions, rebuilt every update
+	GameEngine::SpatialGrid m_humanGrid; ///< The player and the humans for the zombies' nearest target queries, rebuilt every update
+	std::vector<bool> m_infectedHumans; ///< Agents bitten during the current update
+
+	GameEngine::JobSystem m_jobSystem; ///< Runs the agent updates on all cores
+	std::vector<std::vector<std::pair<int, int> > > m_pairBuffers; ///< Overlapping pairs per range of grid rows
+	std::vector<std::pair<int, int> > m_pairs; ///< All overlapping pairs, sorted
+	std::vector<std::vector<AgentContact> > m_contactBuffers; ///< Contacts per range of m_pairs
 
 	int m_numHumansKilled; ///< Humans killed by player
 	int m_numZombiesKilled; ///< Zombies killed by player
@@ -17,7 +17,7 @@ Player::~Player()
 }
 
 
-void Player::init(float speed, glm::vec2 position, GameEngine::InputManager* inputManager, GameEngine::Camera2D* camera, std::vector<Bullet>* bullets){
+void Player::init(float speed, glm::vec2 position, GameEngine::InputManager* inputManager, GameEngine::Camera2D* camera, BulletSystem* bullets){
 	m_speed = speed;
 	m_position = position;
 	m_inputManager = inputManager;
@@ -46,8 +46,7 @@ void Player::addGun(Gun* gun){
 	}
 }
 
-void Player::update(const std::vector<std::string>& levelData,
-	std::vector<Human*>& humans, std::vector<Zombie*>& zombies, float deltaTime){
+void Player::update(const std::vector<std::string>& levelData, float deltaTime){
 	if (m_inputManager->isKeyDown(SDLK_w))
 	{
 		m_position.y += m_speed * deltaTime;
@@ -12,12 +12,11 @@ public:
 	Player();
 	~Player();
 
-	void init(float speed, glm::vec2 position, GameEngine::InputManager* inputManager, GameEngine::Camera2D* camera, std::vector<Bullet>* bullets);
+	void init(float speed, glm::vec2 position, GameEngine::InputManager* inputManager, GameEngine::Camera2D* camera, BulletSystem* bullets);
 
 	void addGun(Gun* gun);
 
-	void update(const std::vector<std::string>& levelData,
-		std::vector<Human*>& humans, std::vector<Zombie*>& zombies, float deltaTime) override;
+	void update(const std::vector<std::string>& levelData, float deltaTime) override;
 
 private:
 	GameEngine::InputManager* m_inputManager;
@@ -25,6 +24,6 @@ private:
 
 	std::vector<Gun*> m_guns;
 	int m_currentGunIndex;
-	std::vector<Bullet>* m_bullets;
+	BulletSystem* m_bullets;
 };
 
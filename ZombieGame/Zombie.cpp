@@ -1,58 +0,0 @@
-#include "Zombie.h"
-
-#include "Human.h"
-
-#include <GameEngine\ResourceManager.h>
-
-Zombie::Zombie()
-{
-	m_health = 150;
-}
-
-
-Zombie::~Zombie()
-{
-
-}
-
-void Zombie::init(float speed, glm::vec2 position){
-	m_color = GameEngine::ColorRGBA8(255, 255, 255, 255);
-	m_speed = speed;
-	m_position = position;
-	m_textureID = GameEngine::ResourceManager::getTexture("Textures/zombie.png").id;
-
-}
-
-void Zombie::update(const std::vector<std::string>& levelData,
-	std::vector<Human*>& humans, std::vector<Zombie*>& zombies, float deltaTime){
-
-	Human* closestHuman = getNearestHuman(humans);
-
-	if (closestHuman != nullptr){
-		m_direction = glm::normalize(closestHuman->getPosition() - m_position);
-		m_position += m_direction * m_speed * deltaTime;
-	}
-
-	collideWithLevel(levelData);
-
-}
-
-Human* Zombie::getNearestHuman(std::vector<Human*>& humans){
-	Human* closestHuman = nullptr;
-	float smallestDistance = 999999999999.0f;
-
-	for (int i = 0; i < humans.size(); i++)
-	{
-		glm::vec2 distVec = humans[i]->getPosition() - m_position;
-		float distance = glm::length(distVec);
-
-		if (distance < smallestDistance){
-			smallestDistance = distance;
-			closestHuman = humans[i];
-		}
-	}
-
-	return closestHuman;
-}
-
-
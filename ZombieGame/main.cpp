@@ -1,6 +1,11 @@
 #include "MainGame.h"
 
+#include <GameEngine/IOManager.h>
+
 int main(int argc, char** argv) {
+    //Release builds ship their assets in one pack, without it the loose files are used
+    GameEngine::IOManager::mountPack("Assets.pak");
+
     MainGame mainGame;
     mainGame.run();
 